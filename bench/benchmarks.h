@@ -0,0 +1,14 @@
+/** benchmarks.h - benchmark tables of the gal containers */
+
+#ifndef GAL_BENCH_BENCHMARKS_H
+#define GAL_BENCH_BENCHMARKS_H
+
+#include "harness.h"
+
+extern bench_def const vector_benchmarks[];
+extern size_t const vector_benchmarks_count;
+
+extern bench_def const container_benchmarks[];
+extern size_t const container_benchmarks_count;
+
+#endif
@@ -0,0 +1,210 @@
+#include "benchmarks.h"
+
+#include <gal/cvector.h>
+#include <gal/intseq.h>
+#include <gal/lru_cache.h>
+#include <gal/spsc_ring.h>
+#include <gal/vector_set.h>
+
+#include <stdlib.h>
+
+#define RING_BATCH 64
+
+static void setup_ring(bench_state* s) {
+  s->ctx = spsc_ring_init(s->element_size, 1024);
+}
+
+static void teardown_ring(bench_state* s) { spsc_ring_deinit(s->ctx); }
+
+static size_t run_ring_single(bench_state* s) {
+  spsc_ring* r = s->ctx;
+  char* out = (char*)s->data;
+  for (size_t i = 0; i < s->size; ++i) {
+    char const* e = (char const*)s->data + i * s->element_size;
+    spsc_ring_push(r, e);
+    spsc_ring_pop(r, out);
+  }
+  return s->size;
+}
+
+static size_t run_ring_batch(bench_state* s) {
+  spsc_ring* r = s->ctx;
+  char* data = s->data;
+  size_t done = 0;
+  while (done < s->size) {
+    size_t n = s->size - done < RING_BATCH ? s->size - done : RING_BATCH;
+    char* chunk = data + done * s->element_size;
+    spsc_ring_push_n(r, chunk, n);
+    spsc_ring_pop_n(r, chunk, n);
+    done += n;
+  }
+  return s->size;
+}
+
+static void setup_cvector(bench_state* s) {
+  s->ctx = cvector_init(s->element_size);
+}
+
+static void teardown_cvector(bench_state* s) { cvector_deinit(s->ctx); }
+
+static size_t run_cvector_push(bench_state* s) {
+  cvector* cv = s->ctx;
+  for (size_t i = 0; i < s->size; ++i) {
+    cvector_push(cv, (char const*)s->data + i * s->element_size);
+  }
+  return s->size;
+}
+
+/* The intseq benchmarks work on their own 64-bit ids */
+typedef struct {
+  uint64_t* ids;
+  intseq* seq;
+} intseq_ctx;
+
+static void setup_intseq(bench_state* s) {
+  intseq_ctx* c = malloc(sizeof(intseq_ctx));
+  c->ids = malloc(s->size * sizeof(uint64_t));
+  uint64_t rng = BENCH_SEED;
+  uint64_t id = 0;
+  for (size_t i = 0; i < s->size; ++i) {
+    id += 1 + bench_random(&rng) % 8;
+    c->ids[i] = id;
+  }
+  c->seq = intseq_init(c->ids, s->size);
+  s->ctx = c;
+}
+
+static void teardown_intseq(bench_state* s) {
+  intseq_ctx* c = s->ctx;
+  intseq_deinit(c->seq);
+  free(c->ids);
+  free(c);
+}
+
+static size_t run_intseq_lower_bound(bench_state* s) {
+  intseq_ctx* c = s->ctx;
+  size_t found = 0;
+  for (size_t i = 0; i < s->size; ++i) {
+    uint64_t key = c->ids[(i * 2654435761u) % s->size];
+    found += intseq_lower_bound(c->seq, key) < s->size;
+  }
+  return found == s->size ? s->size : 0;
+}
+
+static size_t run_intseq_scan(bench_state* s) {
+  intseq_ctx* c = s->ctx;
+  intseq_iter it;
+  uint64_t value, sum = 0;
+  size_t n = 0;
+  intseq_iter_init(&it, c->seq, 0);
+  for (; intseq_iter_next(&it, &value); ++n) {
+    sum += value;
+  }
+  return sum ? n : 0;
+}
+
+/* The set benchmarks intersect two sets of `uint32_t` ids of `size`
+ * elements, or `size` and `size / 64` elements for the asymmetric case, and
+ * count the elements of both inputs, or the lookups of the smaller one, as
+ * operations */
+typedef struct {
+  vector* a;
+  vector* b;
+  vector* small;
+} set_ctx;
+
+static vector* set_ids(size_t n, uint64_t* rng) {
+  vector* v = vector_init(sizeof(uint32_t));
+  uint32_t id = 0;
+  for (size_t i = 0; i < n; ++i) {
+    id += 1 + (uint32_t)(bench_random(rng) % 4);
+    vector_push(v, &id);
+  }
+  return v;
+}
+
+static int cmp_u32(void const* a, void const* b) {
+  uint32_t x = *(uint32_t const*)a, y = *(uint32_t const*)b;
+  return (x > y) - (x < y);
+}
+
+static void setup_set(bench_state* s) {
+  set_ctx* c = malloc(sizeof(set_ctx));
+  uint64_t rng = BENCH_SEED;
+  c->a = set_ids(s->size, &rng);
+  c->b = set_ids(s->size, &rng);
+  c->small = set_ids(s->size / 64 + 1, &rng);
+  s->ctx = c;
+}
+
+static void teardown_set(bench_state* s) {
+  set_ctx* c = s->ctx;
+  vector_deinit(c->small);
+  vector_deinit(c->b);
+  vector_deinit(c->a);
+  free(c);
+}
+
+static size_t run_set_intersection(bench_state* s) {
+  set_ctx* c = s->ctx;
+  vector* out = vector_init(sizeof(uint32_t));
+  vector_set_intersection(out, c->a, c->b, cmp_u32);
+  vector_deinit(out);
+  return vector_size(c->a) + vector_size(c->b);
+}
+
+static size_t run_set_intersection_u32(bench_state* s) {
+  set_ctx* c = s->ctx;
+  vector* out = vector_init(sizeof(uint32_t));
+  vector_set_intersection_u32(out, c->a, c->b);
+  vector_deinit(out);
+  return vector_size(c->a) + vector_size(c->b);
+}
+
+static size_t run_set_intersection_gallop(bench_state* s) {
+  set_ctx* c = s->ctx;
+  vector* out = vector_init(sizeof(uint32_t));
+  vector_set_intersection(out, c->small, c->a, cmp_u32);
+  vector_deinit(out);
+  return vector_size(c->small);
+}
+
+/* The cache benchmarks look up `size` 64-bit keys drawn from 4 * size ids
+ * in a cache that holds a quarter of them */
+static void setup_lru(bench_state* s) {
+  s->ctx = lru_cache_init(sizeof(uint64_t), sizeof(uint64_t), s->size);
+}
+
+static void teardown_lru(bench_state* s) { lru_cache_deinit(s->ctx); }
+
+static size_t run_lru_get_or_put(bench_state* s) {
+  lru_cache* c = s->ctx;
+  uint64_t rng = BENCH_SEED;
+  for (size_t i = 0; i < s->size; ++i) {
+    uint64_t key = bench_random(&rng) % (4 * s->size);
+    if (!lru_cache_get(c, &key))
+      lru_cache_put(c, &key, &key);
+  }
+  return s->size;
+}
+
+bench_def const container_benchmarks[] = {
+    {"spsc_ring_push_pop", 0, setup_ring, run_ring_single, teardown_ring, 0},
+    {"spsc_ring_push_pop_n", 0, setup_ring, run_ring_batch, teardown_ring, 0},
+    {"cvector_push", 0, setup_cvector, run_cvector_push, teardown_cvector, 0},
+    {"intseq_lower_bound", 0, setup_intseq, run_intseq_lower_bound,
+     teardown_intseq, sizeof(uint64_t)},
+    {"intseq_scan", 0, setup_intseq, run_intseq_scan, teardown_intseq,
+     sizeof(uint64_t)},
+    {"lru_get_or_put", 0, setup_lru, run_lru_get_or_put, teardown_lru,
+     sizeof(uint64_t)},
+    {"set_intersection", 0, setup_set, run_set_intersection, teardown_set,
+     sizeof(uint32_t)},
+    {"set_intersection_u32", 0, setup_set, run_set_intersection_u32,
+     teardown_set, sizeof(uint32_t)},
+    {"set_intersection_gallop", 0, setup_set, run_set_intersection_gallop,
+     teardown_set, sizeof(uint32_t)},
+};
+
+size_t const container_benchmarks_count =
+    sizeof(container_benchmarks) / sizeof(container_benchmarks[0]);
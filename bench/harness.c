@@ -0,0 +1,73 @@
+#include "harness.h"
+#include <string.h>
+
+uint64_t bench_random(uint64_t* state) {
+  uint64_t z = (*state += 0x9e3779b97f4a7c15ull);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+void bench_fill(void* dst, size_t element_size, size_t n, uint64_t* rng) {
+  char* p = dst;
+  memset(p, 0xa5, element_size * n);
+
+  for (size_t i = 0; i < n; ++i, p += element_size) {
+    uint64_t key = bench_random(rng) >> 33;
+    if (element_size == 4) {
+      uint32_t k = (uint32_t)key;
+      memcpy(p, &k, sizeof(k));
+    } else {
+      memcpy(p, &key, sizeof(key));
+    }
+  }
+}
+
+uint64_t bench_key(void const* element, size_t element_size) {
+  if (element_size == 4) {
+    uint32_t k;
+    memcpy(&k, element, sizeof(k));
+    return k;
+  }
+  uint64_t k;
+  memcpy(&k, element, sizeof(k));
+  return k;
+}
+
+static int bench_cmp_u32(void const* a, void const* b) {
+  uint32_t x = *(uint32_t const*)a, y = *(uint32_t const*)b;
+  return (x > y) - (x < y);
+}
+
+static int bench_cmp_u64(void const* a, void const* b) {
+  uint64_t x = *(uint64_t const*)a, y = *(uint64_t const*)b;
+  return (x > y) - (x < y);
+}
+
+int (*bench_cmp(size_t element_size))(void const*, void const*) {
+  return element_size == 4 ? bench_cmp_u32 : bench_cmp_u64;
+}
+
+static int bench_sparse_u32(void const* e) {
+  return *(uint32_t const*)e % 16 == 0;
+}
+
+static int bench_sparse_u64(void const* e) {
+  return *(uint64_t const*)e % 16 == 0;
+}
+
+int (*bench_pred_sparse(size_t element_size))(void const*) {
+  return element_size == 4 ? bench_sparse_u32 : bench_sparse_u64;
+}
+
+static int bench_missing_u32(void const* e) {
+  return *(uint32_t const*)e == UINT32_MAX;
+}
+
+static int bench_missing_u64(void const* e) {
+  return *(uint64_t const*)e == UINT64_MAX;
+}
+
+int (*bench_pred_missing(size_t element_size))(void const*) {
+  return element_size == 4 ? bench_missing_u32 : bench_missing_u64;
+}
@@ -0,0 +1,81 @@
+/** harness.h - minimal benchmark harness for gal */
+
+#ifndef GAL_BENCH_HARNESS_H
+#define GAL_BENCH_HARNESS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <gal/vector.h>
+
+/** Seed of the data generator; every run sees the same data */
+#define BENCH_SEED 0x9e3779b97f4a7c15ull
+
+/** Largest data size for benchmarks that are quadratic in the size */
+#define BENCH_QUADRATIC_LIMIT (16 * 1024)
+
+/** State shared by the setup, run and teardown steps of a benchmark
+ *
+ * @field v
+ * Vector whose allocations are counted, or NULL
+ *
+ * @field data
+ * Generated elements, `size` of them
+ *
+ * @field ctx
+ * Benchmark-specific state
+ */
+typedef struct {
+  size_t element_size;
+  size_t size;
+  vector* v;
+  void* data;
+  void* ctx;
+} bench_state;
+
+/** A benchmark
+ *
+ * `setup` and `teardown` are not timed. `run` returns the number of
+ * operations it performed.
+ *
+ * @field quadratic
+ * Whether the run time grows quadratically with the size; such benchmarks
+ * are skipped above BENCH_QUADRATIC_LIMIT
+ *
+ * @field element_size
+ * Size of the elements the benchmark works on if it is fixed, or 0 to run
+ * the benchmark once for every element size of the harness
+ */
+typedef struct {
+  char const* name;
+  int quadratic;
+  void (*setup)(bench_state* s);
+  size_t (*run)(bench_state* s);
+  void (*teardown)(bench_state* s);
+  size_t element_size;
+} bench_def;
+
+/** Next value of the fixed-seed generator (splitmix64) */
+uint64_t bench_random(uint64_t* state);
+
+/** Fill n elements with random keys
+ *
+ * The key is stored in the first 4 bytes of 4-byte elements and in the first
+ * 8 bytes of larger ones; other bytes are filled with a pattern. Keys are
+ * below 2^31, so `bench_pred_missing` never matches.
+ */
+void bench_fill(void* dst, size_t element_size, size_t n, uint64_t* rng);
+
+/** Read the key of an element */
+uint64_t bench_key(void const* element, size_t element_size);
+
+/** Comparison function over keys for the given element size */
+int (*bench_cmp(size_t element_size))(void const*, void const*);
+
+/** Predicate that is true for keys divisible by 16 */
+int (*bench_pred_sparse(size_t element_size))(void const*);
+
+/** Predicate that is never true */
+int (*bench_pred_missing(size_t element_size))(void const*);
+
+#endif
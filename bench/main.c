@@ -0,0 +1,298 @@
+/** main.c - benchmark runner
+ *
+ * Runs every benchmark over a matrix of element sizes and data sizes, prints
+ * a table and optionally writes the results as JSON. If hardware counters are
+ * available, they are reported per operation next to the times.
+ *
+ * Usage: gal_bench [--json path] [--filter substring] [--repetitions n]
+ *                  [--quick]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "benchmarks.h"
+#include "perf_counters.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_REPETITIONS 5
+#define BENCH_MAX_REPETITIONS 64
+
+static size_t const element_sizes[] = {4, 8, 16, 64};
+static size_t const sizes[] = {1024, 64 * 1024, 1024 * 1024};
+static size_t const quick_sizes[] = {1024, 16 * 1024};
+
+typedef struct {
+  char const* name;
+  size_t element_size;
+  size_t size;
+  size_t ops;
+  double ns_per_op;
+  long long allocations;
+  double counters[BENCH_PERF_COUNTERS];
+} bench_result;
+
+/* One repetition */
+typedef struct {
+  double ns;
+  double counters[BENCH_PERF_COUNTERS];
+} bench_sample;
+
+typedef struct {
+  bench_result* items;
+  size_t size;
+  size_t capacity;
+} bench_results;
+
+static double bench_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static int bench_cmp_sample(void const* a, void const* b) {
+  double x = ((bench_sample const*)a)->ns, y = ((bench_sample const*)b)->ns;
+  return (x > y) - (x < y);
+}
+
+/* Allocations made by the container, or -1 without statistics */
+static long long bench_allocations(bench_state* s) {
+  if (!s->v)
+    return -1;
+  gal_alloc_stats const* stats = vector_alloc_stats(s->v);
+  if (!stats)
+    return -1;
+  return (long long)(stats->allocs + stats->reallocs + stats->copy_allocs);
+}
+
+static bench_result bench_measure(bench_def const* def, size_t element_size,
+                                  size_t size, size_t repetitions,
+                                  bench_perf* perf) {
+  bench_sample samples[BENCH_MAX_REPETITIONS];
+  bench_result result = {def->name, element_size, size, 0, 0, -1, {0}};
+
+  void* data = malloc(element_size * size);
+  if (!data) {
+    fprintf(stderr, "gal_bench: out of memory\n");
+    exit(1);
+  }
+
+  for (size_t r = 0; r < repetitions; ++r) {
+    uint64_t rng = BENCH_SEED;
+    bench_fill(data, element_size, size, &rng);
+
+    bench_state s = {element_size, size, NULL, data, NULL};
+    def->setup(&s);
+    long long before = bench_allocations(&s);
+
+    bench_perf_start(perf);
+    double start = bench_now_ns();
+    size_t ops = def->run(&s);
+    double elapsed = bench_now_ns() - start;
+    bench_perf_stop(perf, samples[r].counters);
+
+    long long after = bench_allocations(&s);
+    def->teardown(&s);
+
+    result.ops = ops;
+    result.allocations = before < 0 ? -1 : after - before;
+    double per_op = ops ? 1.0 / (double)ops : 1.0;
+    samples[r].ns = elapsed * per_op;
+    for (size_t i = 0; i < BENCH_PERF_COUNTERS; ++i) {
+      if (samples[r].counters[i] >= 0)
+        samples[r].counters[i] *= per_op;
+    }
+  }
+
+  /* counters are taken from the same repetition as the median time */
+  qsort(samples, repetitions, sizeof(bench_sample), bench_cmp_sample);
+  bench_sample const* median = &samples[repetitions / 2];
+  result.ns_per_op = median->ns;
+  memcpy(result.counters, median->counters, sizeof(result.counters));
+
+  free(data);
+  return result;
+}
+
+static void bench_results_push(bench_results* results, bench_result r) {
+  if (results->size == results->capacity) {
+    size_t capacity = results->capacity ? results->capacity * 2 : 64;
+    bench_result* items =
+        realloc(results->items, capacity * sizeof(bench_result));
+    if (!items) {
+      fprintf(stderr, "gal_bench: out of memory\n");
+      exit(1);
+    }
+    results->items = items;
+    results->capacity = capacity;
+  }
+  results->items[results->size++] = r;
+}
+
+static void bench_print_header(int counters) {
+  printf("%-22s %4s %8s %12s %14s %14s %8s", "benchmark", "es", "size",
+         "ns/op", "ops/s", "bytes/s", "allocs");
+  if (counters) {
+    printf(" %6s", "ipc");
+    for (size_t i = 0; i < BENCH_PERF_COUNTERS; ++i) {
+      if (i != BENCH_PERF_INSTRUCTIONS)
+        printf(" %13s", bench_perf_name(i));
+    }
+  }
+  printf("\n");
+}
+
+static void bench_print(bench_result const* r, int counters) {
+  double ops_per_sec = r->ns_per_op > 0 ? 1e9 / r->ns_per_op : 0;
+  printf("%-22s %4zu %8zu %12.2f %14.0f %14.0f", r->name, r->element_size,
+         r->size, r->ns_per_op, ops_per_sec,
+         ops_per_sec * (double)r->element_size);
+  if (r->allocations >= 0)
+    printf(" %8lld", r->allocations);
+  else
+    printf(" %8s", "-");
+
+  if (counters) {
+    double cycles = r->counters[BENCH_PERF_CYCLES];
+    double instructions = r->counters[BENCH_PERF_INSTRUCTIONS];
+    if (cycles > 0 && instructions >= 0)
+      printf(" %6.2f", instructions / cycles);
+    else
+      printf(" %6s", "-");
+
+    for (size_t i = 0; i < BENCH_PERF_COUNTERS; ++i) {
+      if (i == BENCH_PERF_INSTRUCTIONS)
+        continue;
+      if (r->counters[i] >= 0)
+        printf(" %13.3f", r->counters[i]);
+      else
+        printf(" %13s", "-");
+    }
+  }
+  printf("\n");
+  fflush(stdout);
+}
+
+static int bench_write_json(char const* path, bench_results const* results,
+                            size_t repetitions) {
+  FILE* f = fopen(path, "w");
+  if (!f) {
+    perror(path);
+    return -1;
+  }
+
+  fprintf(f, "{\n  \"seed\": %llu,\n  \"repetitions\": %zu,\n",
+          (unsigned long long)BENCH_SEED, repetitions);
+  fprintf(f, "  \"benchmarks\": [\n");
+  for (size_t i = 0; i < results->size; ++i) {
+    bench_result const* r = &results->items[i];
+    double ops_per_sec = r->ns_per_op > 0 ? 1e9 / r->ns_per_op : 0;
+    fprintf(f,
+            "    {\"name\": \"%s\", \"element_size\": %zu, \"size\": %zu, "
+            "\"ops\": %zu, \"ns_per_op\": %.3f, \"ops_per_sec\": %.1f, "
+            "\"bytes_per_sec\": %.1f, \"allocations\": ",
+            r->name, r->element_size, r->size, r->ops, r->ns_per_op,
+            ops_per_sec, ops_per_sec * (double)r->element_size);
+    if (r->allocations >= 0)
+      fprintf(f, "%lld", r->allocations);
+    else
+      fprintf(f, "null");
+
+    fprintf(f, ", \"counters_per_op\": {");
+    for (size_t c = 0; c < BENCH_PERF_COUNTERS; ++c) {
+      fprintf(f, c ? ", \"%s\": " : "\"%s\": ", bench_perf_name(c));
+      if (r->counters[c] >= 0)
+        fprintf(f, "%.4f", r->counters[c]);
+      else
+        fprintf(f, "null");
+    }
+    fprintf(f, "}}");
+    fprintf(f, i + 1 < results->size ? ",\n" : "\n");
+  }
+  fprintf(f, "  ]\n}\n");
+
+  return fclose(f) == 0 ? 0 : -1;
+}
+
+static void bench_usage(void) {
+  fprintf(stderr, "usage: gal_bench [--json path] [--filter substring] "
+                  "[--repetitions n] [--quick]\n");
+}
+
+int main(int argc, char** argv) {
+  char const* json = NULL;
+  char const* filter = NULL;
+  size_t repetitions = BENCH_REPETITIONS;
+  int quick = 0;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+      json = argv[++i];
+    } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+      filter = argv[++i];
+    } else if (strcmp(argv[i], "--repetitions") == 0 && i + 1 < argc) {
+      repetitions = strtoul(argv[++i], NULL, 10);
+      if (repetitions == 0 || repetitions > BENCH_MAX_REPETITIONS) {
+        bench_usage();
+        return 2;
+      }
+    } else if (strcmp(argv[i], "--quick") == 0) {
+      quick = 1;
+    } else {
+      bench_usage();
+      return 2;
+    }
+  }
+
+  struct {
+    bench_def const* defs;
+    size_t count;
+  } const tables[] = {
+      {vector_benchmarks, vector_benchmarks_count},
+      {container_benchmarks, container_benchmarks_count},
+  };
+
+  size_t const* size_list = quick ? quick_sizes : sizes;
+  size_t size_count = quick ? sizeof(quick_sizes) / sizeof(quick_sizes[0])
+                            : sizeof(sizes) / sizeof(sizes[0]);
+
+  bench_perf perf;
+  int counters = bench_perf_open(&perf) > 0;
+  bench_print_header(counters);
+
+  bench_results results = {NULL, 0, 0};
+  for (size_t t = 0; t < sizeof(tables) / sizeof(tables[0]); ++t) {
+    for (size_t d = 0; d < tables[t].count; ++d) {
+      bench_def const* def = &tables[t].defs[d];
+      if (filter && !strstr(def->name, filter))
+        continue;
+
+      size_t const* def_element_sizes =
+          def->element_size ? &def->element_size : element_sizes;
+      size_t element_size_count =
+          def->element_size ? 1
+                            : sizeof(element_sizes) / sizeof(element_sizes[0]);
+
+      for (size_t e = 0; e < element_size_count; ++e) {
+        for (size_t n = 0; n < size_count; ++n) {
+          if (def->quadratic && size_list[n] > BENCH_QUADRATIC_LIMIT)
+            continue;
+          bench_result r = bench_measure(def, def_element_sizes[e],
+                                         size_list[n], repetitions, &perf);
+          bench_print(&r, counters);
+          bench_results_push(&results, r);
+        }
+      }
+    }
+  }
+
+  int rc = 0;
+  if (json && bench_write_json(json, &results, repetitions) != 0)
+    rc = 1;
+
+  bench_perf_close(&perf);
+  free(results.items);
+  return rc;
+}
@@ -0,0 +1,120 @@
+#define _GNU_SOURCE
+
+#include "perf_counters.h"
+
+static char const* const bench_perf_names[BENCH_PERF_COUNTERS] = {
+    "cycles",      "instructions", "branch_misses",
+    "l1d_misses",  "llc_misses",   "dtlb_misses",
+};
+
+char const* bench_perf_name(bench_perf_counter counter) {
+  return bench_perf_names[counter];
+}
+
+#if defined(GAL_BENCH_PERF) && defined(__linux__)
+
+#include <linux/perf_event.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#define BENCH_PERF_CACHE_MISS(cache)                                           \
+  ((cache) | PERF_COUNT_HW_CACHE_OP_READ << 8 |                                \
+   PERF_COUNT_HW_CACHE_RESULT_MISS << 16)
+
+static struct {
+  uint32_t type;
+  uint64_t config;
+} const bench_perf_events[BENCH_PERF_COUNTERS] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE, BENCH_PERF_CACHE_MISS(PERF_COUNT_HW_CACHE_L1D)},
+    {PERF_TYPE_HW_CACHE, BENCH_PERF_CACHE_MISS(PERF_COUNT_HW_CACHE_LL)},
+    {PERF_TYPE_HW_CACHE, BENCH_PERF_CACHE_MISS(PERF_COUNT_HW_CACHE_DTLB)},
+};
+
+static int bench_perf_event_open(uint32_t type, uint64_t config) {
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format =
+      PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+  return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+size_t bench_perf_open(bench_perf* p) {
+  size_t open = 0;
+  for (size_t i = 0; i < BENCH_PERF_COUNTERS; ++i) {
+    p->fds[i] = bench_perf_event_open(bench_perf_events[i].type,
+                                      bench_perf_events[i].config);
+    open += p->fds[i] >= 0;
+  }
+  return open;
+}
+
+void bench_perf_close(bench_perf* p) {
+  for (size_t i = 0; i < BENCH_PERF_COUNTERS; ++i) {
+    if (p->fds[i] >= 0)
+      close(p->fds[i]);
+    p->fds[i] = -1;
+  }
+}
+
+void bench_perf_start(bench_perf* p) {
+  for (size_t i = 0; i < BENCH_PERF_COUNTERS; ++i) {
+    if (p->fds[i] < 0)
+      continue;
+    ioctl(p->fds[i], PERF_EVENT_IOC_RESET, 0);
+    ioctl(p->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+  }
+}
+
+void bench_perf_stop(bench_perf* p, double counts[BENCH_PERF_COUNTERS]) {
+  for (size_t i = 0; i < BENCH_PERF_COUNTERS; ++i) {
+    if (p->fds[i] >= 0)
+      ioctl(p->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+  }
+
+  for (size_t i = 0; i < BENCH_PERF_COUNTERS; ++i) {
+    /* value, time enabled, time running */
+    uint64_t values[3];
+    counts[i] = -1;
+    if (p->fds[i] < 0 || read(p->fds[i], values, sizeof(values)) !=
+                             (ssize_t)sizeof(values))
+      continue;
+    if (values[2] == 0)
+      continue;
+    counts[i] = (double)values[0] * ((double)values[1] / (double)values[2]);
+  }
+}
+
+#else
+
+size_t bench_perf_open(bench_perf* p) {
+  for (size_t i = 0; i < BENCH_PERF_COUNTERS; ++i) {
+    p->fds[i] = -1;
+  }
+  return 0;
+}
+
+void bench_perf_close(bench_perf* p) { (void)p; }
+
+void bench_perf_start(bench_perf* p) { (void)p; }
+
+void bench_perf_stop(bench_perf* p, double counts[BENCH_PERF_COUNTERS]) {
+  (void)p;
+  for (size_t i = 0; i < BENCH_PERF_COUNTERS; ++i) {
+    counts[i] = -1;
+  }
+}
+
+#endif
@@ -0,0 +1,54 @@
+/** perf_counters.h - hardware performance counters for benchmarks */
+
+#ifndef GAL_BENCH_PERF_COUNTERS_H
+#define GAL_BENCH_PERF_COUNTERS_H
+
+#include <stddef.h>
+
+/** Counters collected around every timed run */
+typedef enum {
+  BENCH_PERF_CYCLES,
+  BENCH_PERF_INSTRUCTIONS,
+  BENCH_PERF_BRANCH_MISSES,
+  BENCH_PERF_L1D_MISSES,
+  BENCH_PERF_LLC_MISSES,
+  BENCH_PERF_DTLB_MISSES,
+  BENCH_PERF_COUNTERS
+} bench_perf_counter;
+
+/** Open counters of the calling thread
+ *
+ * @field fds
+ * Descriptor of every counter, or -1 if it is not available
+ */
+typedef struct {
+  int fds[BENCH_PERF_COUNTERS];
+} bench_perf;
+
+/** Open all counters that the kernel and the CPU provide
+ *
+ * Counters are opened with `perf_event_open` for user space of the calling
+ * thread only. Without GAL_BENCH_PERF, on other systems, or when access is
+ * denied (see /proc/sys/kernel/perf_event_paranoid), no counter is opened.
+ *
+ * @returns number of open counters
+ */
+size_t bench_perf_open(bench_perf* p);
+
+/** Close all counters */
+void bench_perf_close(bench_perf* p);
+
+/** Reset and start all open counters */
+void bench_perf_start(bench_perf* p);
+
+/** Stop all open counters and read them
+ *
+ * Counts are scaled up if the kernel had to multiplex the counters. An
+ * unavailable counter reads as -1.
+ */
+void bench_perf_stop(bench_perf* p, double counts[BENCH_PERF_COUNTERS]);
+
+/** Short name of a counter, used as column and JSON key */
+char const* bench_perf_name(bench_perf_counter counter);
+
+#endif
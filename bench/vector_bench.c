@@ -0,0 +1,97 @@
+#include "benchmarks.h"
+#include <stdlib.h>
+
+static char* element(bench_state* s, size_t i) {
+  return (char*)s->data + i * s->element_size;
+}
+
+static void setup_empty(bench_state* s) { s->v = vector_init(s->element_size); }
+
+static void setup_filled(bench_state* s) {
+  s->v = vector_init(s->element_size);
+  for (size_t i = 0; i < s->size; ++i) {
+    vector_push(s->v, element(s, i));
+  }
+}
+
+static void setup_sorted(bench_state* s) {
+  setup_filled(s);
+  vector_quicksort(s->v, bench_cmp(s->element_size));
+}
+
+static void teardown(bench_state* s) {
+  vector_deinit(s->v);
+  s->v = NULL;
+}
+
+static size_t run_push(bench_state* s) {
+  for (size_t i = 0; i < s->size; ++i) {
+    vector_push(s->v, element(s, i));
+  }
+  return s->size;
+}
+
+static size_t run_push_n(bench_state* s) {
+  vector_push_n(s->v, s->data, s->size);
+  return s->size;
+}
+
+static size_t run_insert(bench_state* s) {
+  for (size_t i = 0; i < s->size; ++i) {
+    vector_insert(s->v, element(s, i), vector_size(s->v) / 2);
+  }
+  return s->size;
+}
+
+static size_t run_delete(bench_state* s) {
+  for (size_t i = 0; i < s->size; ++i) {
+    vector_delete(s->v, vector_size(s->v) / 2);
+  }
+  return s->size;
+}
+
+static size_t run_pop_front(bench_state* s) {
+  for (size_t i = 0; i < s->size; ++i) {
+    free(vector_pop_front(s->v));
+  }
+  return s->size;
+}
+
+static size_t run_quicksort(bench_state* s) {
+  vector_quicksort(s->v, bench_cmp(s->element_size));
+  return s->size;
+}
+
+static size_t run_bsearch(bench_state* s) {
+  int (*cmp)(void const*, void const*) = bench_cmp(s->element_size);
+  size_t found = 0;
+  for (size_t i = 0; i < s->size; ++i) {
+    found += vector_bsearch(s->v, element(s, i), cmp) != VECTOR_NPOS;
+  }
+  return found;
+}
+
+static size_t run_find(bench_state* s) {
+  size_t index = vector_find(s->v, bench_pred_missing(s->element_size));
+  return index == VECTOR_NPOS ? s->size : index;
+}
+
+static size_t run_remove(bench_state* s) {
+  vector_remove(s->v, bench_pred_sparse(s->element_size));
+  return s->size;
+}
+
+bench_def const vector_benchmarks[] = {
+    {"vector_push", 0, setup_empty, run_push, teardown, 0},
+    {"vector_push_n", 0, setup_empty, run_push_n, teardown, 0},
+    {"vector_insert", 1, setup_filled, run_insert, teardown, 0},
+    {"vector_delete", 1, setup_filled, run_delete, teardown, 0},
+    {"vector_pop_front", 1, setup_filled, run_pop_front, teardown, 0},
+    {"vector_quicksort", 0, setup_filled, run_quicksort, teardown, 0},
+    {"vector_bsearch", 0, setup_sorted, run_bsearch, teardown, 0},
+    {"vector_find", 0, setup_filled, run_find, teardown, 0},
+    {"vector_remove", 0, setup_filled, run_remove, teardown, 0},
+};
+
+size_t const vector_benchmarks_count =
+    sizeof(vector_benchmarks) / sizeof(vector_benchmarks[0]);
@@ -0,0 +1,64 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "vector_model.h"
+
+int LLVMFuzzerTestOneInput(uint8_t const* data, size_t size);
+
+int LLVMFuzzerTestOneInput(uint8_t const* data, size_t size) {
+  size_t op = vector_model_run(data, size);
+  if (op != 0) {
+    fprintf(stderr, "vector_fuzz: vector differs from model after op %zu\n",
+            op);
+    abort();
+  }
+  return 0;
+}
+
+#ifndef GAL_LIBFUZZER
+
+/* Reads a whole stream into a malloc'd buffer */
+static uint8_t* vector_fuzz_read(FILE* f, size_t* size) {
+  size_t capacity = 4096;
+  uint8_t* data = malloc(capacity);
+  *size = 0;
+  while (data) {
+    *size += fread(data + *size, 1, capacity - *size, f);
+    if (*size < capacity)
+      break;
+    capacity *= 2;
+    uint8_t* grown = realloc(data, capacity);
+    if (!grown)
+      free(data);
+    data = grown;
+  }
+  return data;
+}
+
+/* Runs every input file, or standard input if none is given, once; this is
+ * the form AFL and crash reproduction use */
+int main(int argc, char** argv) {
+  for (int i = argc > 1 ? 1 : 0; i < argc; ++i) {
+    FILE* f = i == 0 ? stdin : fopen(argv[i], "rb");
+    if (!f) {
+      perror(argv[i]);
+      return EXIT_FAILURE;
+    }
+
+    size_t size;
+    uint8_t* data = vector_fuzz_read(f, &size);
+    if (f != stdin)
+      fclose(f);
+    if (!data) {
+      fprintf(stderr, "vector_fuzz: out of memory\n");
+      return EXIT_FAILURE;
+    }
+
+    LLVMFuzzerTestOneInput(data, size);
+    free(data);
+  }
+  return EXIT_SUCCESS;
+}
+
+#endif
@@ -0,0 +1,301 @@
+/** vector_model.h - vector operations checked against a reference array */
+
+#ifndef GAL_VECTOR_MODEL_H
+#define GAL_VECTOR_MODEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <gal/vector.h>
+
+/** Largest number of elements the model holds */
+#define VECTOR_MODEL_MAX_SIZE 1024
+
+/** Largest element size the model uses */
+#define VECTOR_MODEL_MAX_ELEMENT 64
+
+/* Fixed-width kernel sizes and sizes that take the generic path */
+static size_t const vector_model_element_sizes[] = {1, 2, 3, 4, 8, 16, 24, 64};
+
+enum {
+  VECTOR_MODEL_PUSH,
+  VECTOR_MODEL_INSERT,
+  VECTOR_MODEL_PREPEND,
+  VECTOR_MODEL_POP,
+  VECTOR_MODEL_POP_FRONT,
+  VECTOR_MODEL_DELETE,
+  VECTOR_MODEL_REMOVE,
+  VECTOR_MODEL_REPLACE,
+  VECTOR_MODEL_FIND,
+  VECTOR_MODEL_SORT,
+  VECTOR_MODEL_BSEARCH,
+  VECTOR_MODEL_RESERVE,
+  VECTOR_MODEL_PUSH_N,
+  VECTOR_MODEL_EXTEND,
+  VECTOR_MODEL_EMPLACE,
+  VECTOR_MODEL_OPS
+};
+
+/** Reference model of a vector
+ *
+ * Every element of the vector repeats its key byte `element_size` times, so
+ * elements with equal keys are identical and the model stores keys only.
+ */
+typedef struct {
+  uint8_t const* data;
+  size_t length;
+  size_t pos;
+  size_t element_size;
+  size_t size;
+  uint8_t keys[VECTOR_MODEL_MAX_SIZE];
+} vector_model;
+
+/* Reads the next input byte; an exhausted input reads as zeros */
+static uint8_t vector_model_byte(vector_model* m) {
+  return m->pos < m->length ? m->data[m->pos++] : 0;
+}
+
+static size_t vector_model_index(vector_model* m, size_t bound) {
+  size_t x = vector_model_byte(m);
+  x |= (size_t)vector_model_byte(m) << 8;
+  return x % bound;
+}
+
+static int vector_model_cmp(void const* a, void const* b) {
+  return *(uint8_t const*)a - *(uint8_t const*)b;
+}
+
+static int vector_model_pred(void const* e) {
+  return (*(uint8_t const*)e & 3) == 0;
+}
+
+static int vector_model_element_is(vector_model* m, void const* e,
+                                   uint8_t key) {
+  uint8_t const* bytes = e;
+  for (size_t i = 0; i < m->element_size; ++i) {
+    if (bytes[i] != key)
+      return 0;
+  }
+  return 1;
+}
+
+static int vector_model_matches(vector_model* m, vector* v) {
+  if (vector_size(v) != m->size || vector_capacity(v) < m->size)
+    return 0;
+  for (size_t i = 0; i < m->size; ++i) {
+    if (!vector_model_element_is(m, vector_at(v, i), m->keys[i]))
+      return 0;
+  }
+  return 1;
+}
+
+static void vector_model_insert(vector_model* m, size_t index, uint8_t key) {
+  memmove(m->keys + index + 1, m->keys + index, m->size - index);
+  m->keys[index] = key;
+  m->size += 1;
+}
+
+static void vector_model_delete(vector_model* m, size_t index) {
+  m->size -= 1;
+  memmove(m->keys + index, m->keys + index + 1, m->size - index);
+}
+
+static int vector_model_sorted(vector_model* m) {
+  for (size_t i = 1; i < m->size; ++i) {
+    if (m->keys[i - 1] > m->keys[i])
+      return 0;
+  }
+  return 1;
+}
+
+/* Applies one operation to the vector and the model; returns 0 if their
+ * results differ */
+static int vector_model_step(vector_model* m, vector* v) {
+  unsigned char el[8 * VECTOR_MODEL_MAX_ELEMENT];
+  size_t es = m->element_size;
+  int full = m->size == VECTOR_MODEL_MAX_SIZE;
+
+  switch (vector_model_byte(m) % VECTOR_MODEL_OPS) {
+  case VECTOR_MODEL_PUSH: {
+    uint8_t key = vector_model_byte(m);
+    if (full)
+      break;
+    memset(el, key, es);
+    vector_push(v, el);
+    m->keys[m->size++] = key;
+    break;
+  }
+  case VECTOR_MODEL_INSERT: {
+    uint8_t key = vector_model_byte(m);
+    size_t index = vector_model_index(m, m->size + 1);
+    if (full)
+      break;
+    memset(el, key, es);
+    vector_insert(v, el, index);
+    vector_model_insert(m, index, key);
+    break;
+  }
+  case VECTOR_MODEL_PREPEND: {
+    uint8_t key = vector_model_byte(m);
+    if (full)
+      break;
+    memset(el, key, es);
+    vector_prepend(v, el);
+    vector_model_insert(m, 0, key);
+    break;
+  }
+  case VECTOR_MODEL_POP: {
+    if (m->size == 0)
+      break;
+    void* e = vector_pop(v);
+    int ok = vector_model_element_is(m, e, m->keys[--m->size]);
+    free(e);
+    return ok;
+  }
+  case VECTOR_MODEL_POP_FRONT: {
+    if (m->size == 0)
+      break;
+    void* e = vector_pop_front(v);
+    int ok = vector_model_element_is(m, e, m->keys[0]);
+    vector_model_delete(m, 0);
+    free(e);
+    return ok;
+  }
+  case VECTOR_MODEL_DELETE: {
+    if (m->size == 0)
+      break;
+    size_t index = vector_model_index(m, m->size);
+    vector_delete(v, index);
+    vector_model_delete(m, index);
+    break;
+  }
+  case VECTOR_MODEL_REMOVE: {
+    vector_remove(v, vector_model_pred);
+    size_t kept = 0;
+    for (size_t i = 0; i < m->size; ++i) {
+      if (!vector_model_pred(&m->keys[i]))
+        m->keys[kept++] = m->keys[i];
+    }
+    m->size = kept;
+    break;
+  }
+  case VECTOR_MODEL_REPLACE: {
+    uint8_t key = vector_model_byte(m);
+    if (m->size == 0)
+      break;
+    size_t index = vector_model_index(m, m->size);
+    memset(el, key, es);
+    vector_replace(v, index, el);
+    m->keys[index] = key;
+    break;
+  }
+  case VECTOR_MODEL_FIND: {
+    size_t expected = VECTOR_NPOS;
+    for (size_t i = 0; i < m->size && expected == VECTOR_NPOS; ++i) {
+      if (vector_model_pred(&m->keys[i]))
+        expected = i;
+    }
+    return vector_find(v, vector_model_pred) == expected;
+  }
+  case VECTOR_MODEL_SORT: {
+    size_t counts[256] = {0};
+    for (size_t i = 0; i < m->size; ++i) {
+      counts[m->keys[i]] += 1;
+    }
+    size_t i = 0;
+    for (size_t key = 0; key < 256; ++key) {
+      for (; counts[key] > 0; --counts[key]) {
+        m->keys[i++] = (uint8_t)key;
+      }
+    }
+    vector_quicksort(v, vector_model_cmp);
+    break;
+  }
+  case VECTOR_MODEL_BSEARCH: {
+    uint8_t key = vector_model_byte(m);
+    if (!vector_model_sorted(m))
+      break;
+    memset(el, key, es);
+    size_t index = vector_bsearch(v, el, vector_model_cmp);
+    if (memchr(m->keys, key, m->size) == NULL)
+      return index == VECTOR_NPOS;
+    return index < m->size && m->keys[index] == key;
+  }
+  case VECTOR_MODEL_RESERVE: {
+    size_t capacity = m->size + vector_model_byte(m);
+    vector_reserve(v, capacity);
+    return vector_capacity(v) >= capacity;
+  }
+  case VECTOR_MODEL_PUSH_N: {
+    size_t n = vector_model_byte(m) % 9;
+    if (m->size + n > VECTOR_MODEL_MAX_SIZE)
+      break;
+    for (size_t i = 0; i < n; ++i) {
+      uint8_t key = vector_model_byte(m);
+      memset(el + i * es, key, es);
+      m->keys[m->size + i] = key;
+    }
+    vector_push_n(v, el, n);
+    m->size += n;
+    break;
+  }
+  case VECTOR_MODEL_EXTEND: {
+    if (2 * m->size > VECTOR_MODEL_MAX_SIZE)
+      break;
+    vector_extend(v, v);
+    memcpy(m->keys + m->size, m->keys, m->size);
+    m->size *= 2;
+    break;
+  }
+  case VECTOR_MODEL_EMPLACE: {
+    uint8_t key = vector_model_byte(m);
+    if (full)
+      break;
+    memset(vector_emplace_back(v), key, es);
+    m->keys[m->size++] = key;
+    break;
+  }
+  }
+  return 1;
+}
+
+/** Run the operations encoded in an input on a vector and the model
+ *
+ * The first byte picks the element size, every following operation is an
+ * opcode byte and its operands. The vector is compared with the model after
+ * every operation.
+ *
+ * @returns 0 if the vector matched the model throughout, otherwise the
+ * 1-based number of the first operation after which it did not
+ */
+static size_t vector_model_run(uint8_t const* data, size_t length) {
+  static size_t const nsizes = sizeof(vector_model_element_sizes) /
+                               sizeof(vector_model_element_sizes[0]);
+  if (length == 0)
+    return 0;
+
+  vector_model* m = malloc(sizeof(vector_model));
+  if (!m)
+    return 0;
+  m->data = data;
+  m->length = length;
+  m->pos = 0;
+  m->element_size = vector_model_element_sizes[vector_model_byte(m) % nsizes];
+  m->size = 0;
+
+  vector* v = vector_init(m->element_size);
+  size_t failed = 0;
+  for (size_t op = 1; v && !failed && m->pos < m->length; ++op) {
+    if (!vector_model_step(m, v) || !vector_model_matches(m, v))
+      failed = op;
+  }
+
+  if (v)
+    vector_deinit(v);
+  free(m);
+  return failed;
+}
+
+#endif
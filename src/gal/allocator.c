@@ -1,10 +1,22 @@
+#define _GNU_SOURCE
+
 #include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 #include "allocator.h"
 
+#define GAL_HUGE_PAGE_SIZE ((size_t)2 * 1024 * 1024)
+
+#ifndef MPOL_BIND
+#define MPOL_BIND 2
+#define MPOL_INTERLEAVE 3
+#endif
+
 void* gal_std_allocator(void* ptr, size_t old_size, size_t new_size) {
   if (old_size == 0 && new_size == 0)
     return NULL;
@@ -23,3 +35,169 @@ void* gal_std_allocator(void* ptr, size_t old_size, size_t new_size) {
 
   return p;
 }
+
+static gal_large_alloc_config gal_large_config = {
+    GAL_HUGE_PAGES_TRANSPARENT,
+    GAL_NUMA_DEFAULT,
+    0,
+};
+
+void gal_large_allocator_configure(gal_large_alloc_config const* config) {
+  gal_large_config = *config;
+}
+
+/* Length of the mapping that backs a block. It depends only on the block
+ * size, so it can be recomputed when the block is resized or freed. */
+static size_t gal_large_length(size_t size) {
+  size_t granule = GAL_HUGE_PAGE_SIZE;
+  if (size < GAL_HUGE_PAGE_SIZE)
+    granule = (size_t)sysconf(_SC_PAGESIZE);
+  return (size + granule - 1) / granule * granule;
+}
+
+static void gal_large_advise(void* addr, size_t length) {
+#ifdef MADV_HUGEPAGE
+  if (gal_large_config.huge_pages != GAL_HUGE_PAGES_NONE &&
+      length >= GAL_HUGE_PAGE_SIZE)
+    madvise(addr, length, MADV_HUGEPAGE);
+#endif
+
+#ifdef SYS_mbind
+  int mode = 0;
+  if (gal_large_config.numa_policy == GAL_NUMA_BIND)
+    mode = MPOL_BIND;
+  else if (gal_large_config.numa_policy == GAL_NUMA_INTERLEAVE)
+    mode = MPOL_INTERLEAVE;
+
+  if (mode) {
+    unsigned long mask = gal_large_config.numa_nodes;
+    syscall(SYS_mbind, addr, length, mode, &mask, sizeof(mask) * 8 + 1, 0);
+  }
+#else
+  (void)addr;
+  (void)length;
+#endif
+}
+
+static void* gal_large_map(size_t length) {
+  void* p = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+  if (gal_large_config.huge_pages == GAL_HUGE_PAGES_HUGETLB &&
+      length % GAL_HUGE_PAGE_SIZE == 0) {
+    p = mmap(NULL, length, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  }
+#endif
+
+  if (p == MAP_FAILED) {
+    p = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+             -1, 0);
+  }
+  if (p == MAP_FAILED)
+    return NULL;
+
+  gal_large_advise(p, length);
+  return p;
+}
+
+void* gal_large_allocator(void* ptr, size_t old_size, size_t new_size) {
+  if (old_size == 0 && new_size == 0)
+    return NULL;
+
+  size_t old_length = old_size ? gal_large_length(old_size) : 0;
+  if (new_size == 0) {
+    munmap(ptr, old_length);
+    return NULL;
+  }
+
+  size_t new_length = gal_large_length(new_size);
+  if (!ptr || old_size == 0)
+    return gal_large_map(new_length);
+  if (new_length == old_length)
+    return ptr;
+
+  void* p;
+#ifdef MREMAP_MAYMOVE
+  p = mremap(ptr, old_length, new_length, MREMAP_MAYMOVE);
+  if (p != MAP_FAILED) {
+    gal_large_advise(p, new_length);
+    return p;
+  }
+#endif
+
+  /* mremap is unavailable or refused, e.g. for a huge page mapping resized
+   * to a length that is not a multiple of the huge page size */
+  p = gal_large_map(new_length);
+  if (!p) {
+    fprintf(stderr,
+            "gal_large_allocator error: old size %zu, new size %zu, error %s",
+            old_size, new_size, strerror(errno));
+    return NULL;
+  }
+  memcpy(p, ptr, old_size < new_size ? old_size : new_size);
+  munmap(ptr, old_length);
+  return p;
+}
+
+void* gal_tiered_allocator(void* ptr, size_t old_size, size_t new_size) {
+  int old_large = old_size >= GAL_LARGE_ALLOC_THRESHOLD;
+  int new_large = new_size >= GAL_LARGE_ALLOC_THRESHOLD;
+
+  if (new_size == 0 || old_size == 0 || old_large == new_large) {
+    if (old_large || (old_size == 0 && new_large))
+      return gal_large_allocator(ptr, old_size, new_size);
+    return gal_std_allocator(ptr, old_size, new_size);
+  }
+
+  gal_allocator from = old_large ? gal_large_allocator : gal_std_allocator;
+  gal_allocator to = new_large ? gal_large_allocator : gal_std_allocator;
+
+  void* p = to(NULL, 0, new_size);
+  if (!p)
+    return NULL;
+  memcpy(p, ptr, old_size < new_size ? old_size : new_size);
+  from(ptr, old_size, 0);
+  return p;
+}
+
+static size_t gal_stats_class(size_t size) {
+  size_t k = sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(size);
+  return k < GAL_ALLOC_STATS_CLASSES ? k : GAL_ALLOC_STATS_CLASSES - 1;
+}
+
+void* gal_stats_allocate(gal_alloc_stats* stats, gal_allocator allocator,
+                         void* ptr, size_t old_size, size_t new_size) {
+  void* p = allocator(ptr, old_size, new_size);
+
+  if (new_size == 0) {
+    if (old_size > 0) {
+      stats->frees += 1;
+      stats->bytes_live -= old_size;
+    }
+    return p;
+  }
+
+  if (!p)
+    return NULL;
+
+  if (old_size == 0) {
+    stats->allocs += 1;
+  } else {
+    stats->reallocs += 1;
+    if (p != ptr)
+      stats->realloc_copy_bytes += old_size < new_size ? old_size : new_size;
+  }
+
+  stats->histogram[gal_stats_class(new_size)] += 1;
+  stats->bytes_live += new_size - old_size;
+  if (stats->bytes_live > stats->bytes_peak)
+    stats->bytes_peak = stats->bytes_live;
+
+  return p;
+}
+
+void gal_stats_record_copy(gal_alloc_stats* stats, size_t size) {
+  stats->copy_allocs += 1;
+  stats->copy_bytes += size;
+}
@@ -3,6 +3,13 @@
 
 #include <stddef.h>
 
+/** Allocator hook
+ *
+ * Function with the same contract as `gal_std_allocator`. Modules that take
+ * an allocator accept any function of this type.
+ */
+typedef void* (*gal_allocator)(void* ptr, size_t old_size, size_t new_size);
+
 /** Memory allocator
  *
  * Work principle:
@@ -18,4 +25,134 @@
  */
 void* gal_std_allocator(void* ptr, size_t old_size, size_t new_size);
 
+/** Block size from which `gal_tiered_allocator` uses `gal_large_allocator`
+ *
+ * Must be the same for every translation unit, since the tiered allocator
+ * derives the backend of a block from its size.
+ */
+#ifndef GAL_LARGE_ALLOC_THRESHOLD
+#define GAL_LARGE_ALLOC_THRESHOLD (2 * 1024 * 1024)
+#endif
+
+/** Huge page modes of `gal_large_allocator` */
+enum {
+  GAL_HUGE_PAGES_NONE,        /* regular pages */
+  GAL_HUGE_PAGES_TRANSPARENT, /* madvise(MADV_HUGEPAGE) */
+  GAL_HUGE_PAGES_HUGETLB      /* MAP_HUGETLB, transparent as a fallback */
+};
+
+/** NUMA placement policies of `gal_large_allocator` */
+enum {
+  GAL_NUMA_DEFAULT,   /* policy of the calling thread */
+  GAL_NUMA_BIND,      /* only the nodes in the mask */
+  GAL_NUMA_INTERLEAVE /* pages spread over the nodes in the mask */
+};
+
+/** Configuration of `gal_large_allocator`
+ *
+ * @field huge_pages
+ * One of GAL_HUGE_PAGES_*
+ *
+ * @field numa_policy
+ * One of GAL_NUMA_*
+ *
+ * @field numa_nodes
+ * Bit mask of NUMA nodes for GAL_NUMA_BIND and GAL_NUMA_INTERLEAVE
+ */
+typedef struct {
+  int huge_pages;
+  int numa_policy;
+  unsigned long numa_nodes;
+} gal_large_alloc_config;
+
+/** Configure `gal_large_allocator`
+ *
+ * Applies to blocks allocated or grown afterwards. Not thread-safe; meant to
+ * be called at startup. The default is transparent huge pages without a NUMA
+ * policy.
+ */
+void gal_large_allocator_configure(gal_large_alloc_config const* config);
+
+/** Memory allocator for large blocks
+ *
+ * Follows the contract of `gal_std_allocator`, but serves every block with
+ * its own anonymous mapping. Blocks of at least a huge page are rounded up to
+ * whole huge pages and backed by huge pages as configured, which cuts TLB
+ * misses on random access. Blocks are grown in place or moved by `mremap`
+ * without copying. Hints that the system does not support (huge pages, NUMA
+ * policies) are silently skipped.
+ */
+void* gal_large_allocator(void* ptr, size_t old_size, size_t new_size);
+
+/** Memory allocator that picks a backend by block size
+ *
+ * Blocks smaller than GAL_LARGE_ALLOC_THRESHOLD come from
+ * `gal_std_allocator`, larger ones from `gal_large_allocator`. A block that
+ * crosses the threshold is copied to the other backend.
+ */
+void* gal_tiered_allocator(void* ptr, size_t old_size, size_t new_size);
+
+/** Number of size classes in `gal_alloc_stats`
+ *
+ * Class k counts requests of [2^k, 2^(k+1)) bytes; the last class also
+ * counts all larger requests.
+ */
+#define GAL_ALLOC_STATS_CLASSES 32
+
+/** Allocation statistics
+ *
+ * Containers keep one per instance when the library is built with
+ * GAL_ALLOC_STATS; otherwise they are not collected at all.
+ *
+ * @field allocs
+ * Number of new blocks
+ *
+ * @field frees
+ * Number of freed blocks
+ *
+ * @field reallocs
+ * Number of resized blocks
+ *
+ * @field bytes_live
+ * Bytes currently allocated
+ *
+ * @field bytes_peak
+ * Maximum of bytes_live
+ *
+ * @field realloc_copy_bytes
+ * Bytes moved by reallocations that returned a different address
+ *
+ * @field copy_allocs
+ * Number of blocks allocated to return element copies to the caller, such as
+ * the results of `vector_pop`; the caller frees them, so they are not part of
+ * bytes_live
+ *
+ * @field copy_bytes
+ * Bytes allocated for element copies
+ *
+ * @field histogram
+ * Number of allocations and reallocations per size class of the new size
+ */
+typedef struct {
+  size_t allocs;
+  size_t frees;
+  size_t reallocs;
+  size_t bytes_live;
+  size_t bytes_peak;
+  size_t realloc_copy_bytes;
+  size_t copy_allocs;
+  size_t copy_bytes;
+  size_t histogram[GAL_ALLOC_STATS_CLASSES];
+} gal_alloc_stats;
+
+/** Allocate through an allocator and record the call in stats
+ *
+ * Has the contract of `gal_std_allocator`. Failed calls are not recorded.
+ */
+void* gal_stats_allocate(gal_alloc_stats* stats, gal_allocator allocator,
+                         void* ptr, size_t old_size, size_t new_size);
+
+/** Record an element copy allocated for the caller */
+void gal_stats_record_copy(gal_alloc_stats* stats, size_t size);
+
 #endif
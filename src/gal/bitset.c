@@ -0,0 +1,244 @@
+#include "bitset.h"
+#include <stdlib.h>
+#include <string.h>
+
+static size_t bitset_popcount(uint64_t w) {
+  return (size_t)__builtin_popcountll(w);
+}
+
+static size_t bitset_nblocks(bitset* bs) {
+  return (bs->_nwords + BITSET_RANK_BLOCK - 1) / BITSET_RANK_BLOCK;
+}
+
+/* Clears the bits past the size in the last word */
+static void bitset_trim(bitset* bs) {
+  size_t tail = bs->_size % BITSET_WORD_BITS;
+  if (tail)
+    bs->_words[bs->_nwords - 1] &= (UINT64_C(1) << tail) - 1;
+}
+
+/* Makes the rank directory current; returns 0 if it can not be allocated */
+static int bitset_build_rank(bitset* bs) {
+  if (bs->_rank_valid)
+    return 1;
+
+  size_t nblocks = bitset_nblocks(bs);
+  if (!bs->_rank) {
+    bs->_rank = malloc((nblocks + 1) * sizeof(uint64_t));
+    if (!bs->_rank)
+      return 0;
+  }
+
+  uint64_t total = 0;
+  for (size_t b = 0; b < nblocks; ++b) {
+    bs->_rank[b] = total;
+    size_t end = (b + 1) * BITSET_RANK_BLOCK;
+    if (end > bs->_nwords)
+      end = bs->_nwords;
+    for (size_t w = b * BITSET_RANK_BLOCK; w < end; ++w) {
+      total += bitset_popcount(bs->_words[w]);
+    }
+  }
+  bs->_rank[nblocks] = total;
+  bs->_rank_valid = 1;
+  return 1;
+}
+
+bitset* bitset_init(size_t size) {
+  bitset* bs = malloc(sizeof(bitset));
+  if (!bs)
+    return NULL;
+
+  bs->_size = size;
+  bs->_nwords = (size + BITSET_WORD_BITS - 1) / BITSET_WORD_BITS;
+  bs->_words = calloc(bs->_nwords ? bs->_nwords : 1, sizeof(uint64_t));
+  if (!bs->_words) {
+    free(bs);
+    return NULL;
+  }
+  bs->_rank = NULL;
+  bs->_rank_valid = 0;
+  return bs;
+}
+
+bitset* bitset_from_vector(vector* v, int (*predicate)(void const*)) {
+  size_t size = vector_size(v);
+  bitset* bs = bitset_init(size);
+  if (!bs)
+    return NULL;
+
+  /* Accumulate a word at a time instead of a read-modify-write per bit */
+  for (size_t w = 0; w < bs->_nwords; ++w) {
+    size_t begin = w * BITSET_WORD_BITS;
+    size_t end = begin + BITSET_WORD_BITS < size ? begin + BITSET_WORD_BITS
+                                                  : size;
+    uint64_t word = 0;
+    for (size_t i = begin; i < end; ++i) {
+      word |= (uint64_t)(predicate(vector_at_unchecked(v, i)) != 0)
+              << (i - begin);
+    }
+    bs->_words[w] = word;
+  }
+  return bs;
+}
+
+void bitset_deinit(bitset* bs) {
+  free(bs->_rank);
+  free(bs->_words);
+  free(bs);
+}
+
+size_t bitset_size(bitset* bs) { return bs->_size; }
+
+void bitset_set(bitset* bs, size_t index) {
+  assert(index < bs->_size && "bitset_set");
+  bs->_words[index / BITSET_WORD_BITS] |= UINT64_C(1)
+                                           << (index % BITSET_WORD_BITS);
+  bs->_rank_valid = 0;
+}
+
+void bitset_clear(bitset* bs, size_t index) {
+  assert(index < bs->_size && "bitset_clear");
+  bs->_words[index / BITSET_WORD_BITS] &=
+      ~(UINT64_C(1) << (index % BITSET_WORD_BITS));
+  bs->_rank_valid = 0;
+}
+
+void bitset_set_all(bitset* bs) {
+  memset(bs->_words, 0xff, bs->_nwords * sizeof(uint64_t));
+  bitset_trim(bs);
+  bs->_rank_valid = 0;
+}
+
+void bitset_clear_all(bitset* bs) {
+  memset(bs->_words, 0, bs->_nwords * sizeof(uint64_t));
+  bs->_rank_valid = 0;
+}
+
+size_t bitset_count(bitset* bs) {
+  if (bs->_rank_valid)
+    return bs->_rank[bitset_nblocks(bs)];
+
+  size_t count = 0;
+  for (size_t w = 0; w < bs->_nwords; ++w) {
+    count += bitset_popcount(bs->_words[w]);
+  }
+  return count;
+}
+
+size_t bitset_rank(bitset* bs, size_t index) {
+  assert(index <= bs->_size && "bitset_rank");
+
+  size_t word = index / BITSET_WORD_BITS;
+  size_t first = 0;
+  size_t count = 0;
+  if (bitset_build_rank(bs)) {
+    first = word / BITSET_RANK_BLOCK * BITSET_RANK_BLOCK;
+    count = bs->_rank[word / BITSET_RANK_BLOCK];
+  }
+
+  for (size_t w = first; w < word; ++w) {
+    count += bitset_popcount(bs->_words[w]);
+  }
+  size_t bit = index % BITSET_WORD_BITS;
+  if (bit)
+    count += bitset_popcount(bs->_words[word] & ((UINT64_C(1) << bit) - 1));
+  return count;
+}
+
+size_t bitset_select(bitset* bs, size_t k) {
+  size_t w = 0;
+  if (bitset_build_rank(bs)) {
+    size_t nblocks = bitset_nblocks(bs);
+    if (bs->_rank[nblocks] <= k)
+      return BITSET_NPOS;
+
+    /* Last block with fewer than k + 1 set bits before it */
+    size_t lo = 0, hi = nblocks;
+    while (hi - lo > 1) {
+      size_t mid = lo + (hi - lo) / 2;
+      if (bs->_rank[mid] <= k)
+        lo = mid;
+      else
+        hi = mid;
+    }
+    k -= bs->_rank[lo];
+    w = lo * BITSET_RANK_BLOCK;
+  }
+
+  for (; w < bs->_nwords; ++w) {
+    uint64_t word = bs->_words[w];
+    size_t count = bitset_popcount(word);
+    if (k < count) {
+      /* Drop the k lowest set bits */
+      for (; k > 0; --k) {
+        word &= word - 1;
+      }
+      return w * BITSET_WORD_BITS + (size_t)__builtin_ctzll(word);
+    }
+    k -= count;
+  }
+  return BITSET_NPOS;
+}
+
+size_t bitset_find_next(bitset* bs, size_t from) {
+  if (from >= bs->_size)
+    return BITSET_NPOS;
+
+  size_t w = from / BITSET_WORD_BITS;
+  uint64_t word = bs->_words[w] & (~UINT64_C(0) << (from % BITSET_WORD_BITS));
+  while (!word) {
+    if (++w == bs->_nwords)
+      return BITSET_NPOS;
+    word = bs->_words[w];
+  }
+  return w * BITSET_WORD_BITS + (size_t)__builtin_ctzll(word);
+}
+
+void bitset_and(bitset* restrict dst, bitset const* restrict src) {
+  assert(dst->_size == src->_size && "bitset_and");
+  uint64_t* restrict d = dst->_words;
+  uint64_t const* restrict s = src->_words;
+  for (size_t w = 0; w < dst->_nwords; ++w) {
+    d[w] &= s[w];
+  }
+  dst->_rank_valid = 0;
+}
+
+void bitset_or(bitset* restrict dst, bitset const* restrict src) {
+  assert(dst->_size == src->_size && "bitset_or");
+  uint64_t* restrict d = dst->_words;
+  uint64_t const* restrict s = src->_words;
+  for (size_t w = 0; w < dst->_nwords; ++w) {
+    d[w] |= s[w];
+  }
+  dst->_rank_valid = 0;
+}
+
+void bitset_xor(bitset* restrict dst, bitset const* restrict src) {
+  assert(dst->_size == src->_size && "bitset_xor");
+  uint64_t* restrict d = dst->_words;
+  uint64_t const* restrict s = src->_words;
+  for (size_t w = 0; w < dst->_nwords; ++w) {
+    d[w] ^= s[w];
+  }
+  dst->_rank_valid = 0;
+}
+
+void bitset_andnot(bitset* restrict dst, bitset const* restrict src) {
+  assert(dst->_size == src->_size && "bitset_andnot");
+  uint64_t* restrict d = dst->_words;
+  uint64_t const* restrict s = src->_words;
+  for (size_t w = 0; w < dst->_nwords; ++w) {
+    d[w] &= ~s[w];
+  }
+  dst->_rank_valid = 0;
+}
+
+void bitset_flip_all(bitset* bs) {
+  for (size_t w = 0; w < bs->_nwords; ++w) {
+    bs->_words[w] = ~bs->_words[w];
+  }
+  bitset_trim(bs);
+  bs->_rank_valid = 0;
+}
@@ -0,0 +1,144 @@
+/** bitset.h - packed bit vector with rank, select and bulk operations */
+
+#ifndef GAL_BITSET_H
+#define GAL_BITSET_H
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "vector.h"
+
+/** Returned by searches that find no bit */
+#define BITSET_NPOS VECTOR_NPOS
+
+/** Number of bits in a word of a bitset */
+#define BITSET_WORD_BITS 64
+
+/** Number of words covered by one entry of the rank directory */
+#define BITSET_RANK_BLOCK 8
+
+/** Fixed-size sequence of bits packed into 64-bit words
+ *
+ * Takes one bit per flag where a `vector` of bytes takes eight. Bits past
+ * the size in the last word are always zero, so whole-word operations never
+ * need to mask them.
+ *
+ * `bitset_rank` and `bitset_select` use a directory of cumulative counts, one
+ * per BITSET_RANK_BLOCK words, that is built on first use and discarded by
+ * every update.
+ *
+ * @field _words
+ * Bits, bit i is bit `i % 64` of word `i / 64`
+ *
+ * @field _rank
+ * Number of set bits before every block, allocated on first use
+ *
+ * @field _rank_valid
+ * Whether `_rank` matches the bits
+ */
+typedef struct {
+  size_t _size;
+  size_t _nwords;
+  uint64_t* _words;
+  uint64_t* _rank;
+  int _rank_valid;
+} bitset;
+
+/** Create a bitset with all bits cleared
+ *
+ * @param size number of bits
+ * @returns bitset or NULL if memory can not be allocated
+ */
+bitset* bitset_init(size_t size);
+
+/** Create a bitset with one bit per element of a vector
+ *
+ * Bit i is set if the predicate is true on element i.
+ *
+ * @returns bitset or NULL if memory can not be allocated
+ *
+ * Complexity: O(n)
+ */
+bitset* bitset_from_vector(vector* v, int (*predicate)(void const*));
+
+/** Destroy a bitset */
+void bitset_deinit(bitset* bs);
+
+/** Get the number of bits */
+size_t bitset_size(bitset* bs);
+
+/** Set a bit */
+void bitset_set(bitset* bs, size_t index);
+
+/** Clear a bit */
+void bitset_clear(bitset* bs, size_t index);
+
+/** Set all bits */
+void bitset_set_all(bitset* bs);
+
+/** Clear all bits */
+void bitset_clear_all(bitset* bs);
+
+/** Test a bit
+ *
+ * Returns 1 if the bit is set and 0 otherwise.
+ */
+static inline int bitset_test(bitset* bs, size_t index) {
+  assert(index < bs->_size && "bitset_test");
+  return (bs->_words[index / BITSET_WORD_BITS] >>
+          (index % BITSET_WORD_BITS)) &
+         1;
+}
+
+/** Count the set bits
+ *
+ * Complexity: O(n / 64)
+ */
+size_t bitset_count(bitset* bs);
+
+/** Count the set bits before an index
+ *
+ * @param index position in [0, size]
+ *
+ * Complexity: O(1) once the rank directory is built, O(n / 64) otherwise
+ */
+size_t bitset_rank(bitset* bs, size_t index);
+
+/** Find the position of a set bit by its rank
+ *
+ * @param k number of set bits before the wanted one
+ * @returns position of the bit or BITSET_NPOS if fewer than k + 1 bits are
+ * set
+ *
+ * Complexity: O(log n) once the rank directory is built
+ */
+size_t bitset_select(bitset* bs, size_t k);
+
+/** Find the first set bit at or after an index
+ *
+ * Skips whole zero words and locates the bit with a count of trailing zeros.
+ *
+ * @returns position of the bit or BITSET_NPOS if there is none
+ */
+size_t bitset_find_next(bitset* bs, size_t from);
+
+/** Bitwise operations over whole sets
+ *
+ * Combine `dst` with `src` in place, word by word, in a loop the compiler
+ * can vectorize. Both sets must have the same size and must not be the same
+ * set.
+ *
+ * Complexity: O(n / 64)
+ */
+void bitset_and(bitset* restrict dst, bitset const* restrict src);
+void bitset_or(bitset* restrict dst, bitset const* restrict src);
+void bitset_xor(bitset* restrict dst, bitset const* restrict src);
+
+/** Clear the bits of `dst` that are set in `src` */
+void bitset_andnot(bitset* restrict dst, bitset const* restrict src);
+
+/** Invert all bits */
+void bitset_flip_all(bitset* bs);
+
+#endif
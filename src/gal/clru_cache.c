@@ -0,0 +1,125 @@
+#include "clru_cache.h"
+#include "platform.h"
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+  _Alignas(GAL_CACHE_LINE_SIZE) pthread_mutex_t lock;
+  lru_cache* cache;
+} clru_shard;
+
+struct clru_cache {
+  size_t key_size;
+  size_t value_size;
+  size_t nshards;
+  clru_shard* shards;
+};
+
+/* The shard comes from the high half of the hash, the index slot of a shard
+ * from the low half, so keys of one shard still spread over its index */
+static clru_shard* clru_cache_shard(clru_cache* c, uint64_t hash) {
+  return &c->shards[(hash >> 32) & (c->nshards - 1)];
+}
+
+clru_cache* clru_cache_init(size_t key_size, size_t value_size,
+                            size_t capacity, size_t shards) {
+  clru_cache* c = malloc(sizeof(clru_cache));
+  if (!c)
+    return NULL;
+
+  size_t nshards = 1;
+  while (nshards < (shards ? shards : CLRU_CACHE_SHARDS)) {
+    nshards *= 2;
+  }
+
+  c->key_size = key_size;
+  c->value_size = value_size;
+  c->nshards = nshards;
+  c->shards = aligned_alloc(GAL_CACHE_LINE_SIZE, nshards * sizeof(clru_shard));
+  if (!c->shards) {
+    free(c);
+    errno = ENOMEM;
+    return NULL;
+  }
+
+  size_t shard_capacity = (capacity + nshards - 1) / nshards;
+  for (size_t i = 0; i < nshards; ++i) {
+    clru_shard* s = &c->shards[i];
+    s->cache = lru_cache_init(key_size, value_size, shard_capacity);
+    if (!s->cache) {
+      c->nshards = i;
+      clru_cache_deinit(c);
+      errno = ENOMEM;
+      return NULL;
+    }
+    pthread_mutex_init(&s->lock, NULL);
+  }
+  return c;
+}
+
+void clru_cache_deinit(clru_cache* c) {
+  for (size_t i = 0; i < c->nshards; ++i) {
+    pthread_mutex_destroy(&c->shards[i].lock);
+    lru_cache_deinit(c->shards[i].cache);
+  }
+  free(c->shards);
+  free(c);
+}
+
+size_t clru_cache_size(clru_cache* c) {
+  size_t size = 0;
+  for (size_t i = 0; i < c->nshards; ++i) {
+    clru_shard* s = &c->shards[i];
+    pthread_mutex_lock(&s->lock);
+    size += lru_cache_size(s->cache);
+    pthread_mutex_unlock(&s->lock);
+  }
+  return size;
+}
+
+int clru_cache_get(clru_cache* c, void const* key, void* value) {
+  uint64_t hash = _lru_cache_hash(key, c->key_size);
+  clru_shard* s = clru_cache_shard(c, hash);
+
+  pthread_mutex_lock(&s->lock);
+  void* found = _lru_cache_get_hashed(s->cache, key, hash);
+  if (found)
+    memcpy(value, found, c->value_size);
+  pthread_mutex_unlock(&s->lock);
+  return found != NULL;
+}
+
+void clru_cache_put(clru_cache* c, void const* key, void const* value) {
+  uint64_t hash = _lru_cache_hash(key, c->key_size);
+  clru_shard* s = clru_cache_shard(c, hash);
+
+  pthread_mutex_lock(&s->lock);
+  _lru_cache_put_hashed(s->cache, key, hash, value);
+  pthread_mutex_unlock(&s->lock);
+}
+
+int clru_cache_remove(clru_cache* c, void const* key) {
+  uint64_t hash = _lru_cache_hash(key, c->key_size);
+  clru_shard* s = clru_cache_shard(c, hash);
+
+  pthread_mutex_lock(&s->lock);
+  int removed = _lru_cache_remove_hashed(s->cache, key, hash);
+  pthread_mutex_unlock(&s->lock);
+  return removed;
+}
+
+lru_stats clru_cache_stats(clru_cache* c) {
+  lru_stats total = {0, 0, 0};
+  for (size_t i = 0; i < c->nshards; ++i) {
+    clru_shard* s = &c->shards[i];
+    pthread_mutex_lock(&s->lock);
+    lru_stats stats = lru_cache_stats(s->cache);
+    pthread_mutex_unlock(&s->lock);
+    total.hits += stats.hits;
+    total.misses += stats.misses;
+    total.evictions += stats.evictions;
+  }
+  return total;
+}
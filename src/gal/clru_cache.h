@@ -0,0 +1,75 @@
+/** clru_cache.h - sharded LRU cache for concurrent access */
+
+#ifndef GAL_CLRU_CACHE_H
+#define GAL_CLRU_CACHE_H
+
+#include <stddef.h>
+
+#include "lru_cache.h"
+
+/** Number of shards picked when 0 is passed to `clru_cache_init` */
+#define CLRU_CACHE_SHARDS 16
+
+/** LRU cache that many threads can use at once
+ *
+ * Keys are spread over independent `lru_cache` shards by their hash, and
+ * every shard has its own mutex on its own cache line, so threads working
+ * on different keys rarely contend. Recency and eviction are tracked per
+ * shard: the evicted entry is the least recently used one of its shard,
+ * not necessarily of the whole cache.
+ *
+ * Values are copied in and out under the shard lock, since a pointer into a
+ * shard could be invalidated by another thread at any time.
+ *
+ * Available only if the library is built with GAL_THREADS.
+ */
+typedef struct clru_cache clru_cache;
+
+/** Create a sharded cache
+ *
+ * The capacity is divided evenly between the shards, rounding up.
+ *
+ * @param shards number of shards, rounded up to a power of two, or 0 for
+ * CLRU_CACHE_SHARDS
+ * @returns cache or NULL if memory can not be allocated
+ */
+clru_cache* clru_cache_init(size_t key_size, size_t value_size,
+                            size_t capacity, size_t shards);
+
+/** Destroy a sharded cache
+ *
+ * No other thread may be using the cache.
+ */
+void clru_cache_deinit(clru_cache* c);
+
+/** Get the number of entries
+ *
+ * The result may be stale if other threads update the cache.
+ */
+size_t clru_cache_size(clru_cache* c);
+
+/** Look up a key and copy its value
+ *
+ * Marks the entry as most recently used and counts a hit or a miss.
+ *
+ * @returns 1 if the key is cached, 0 otherwise
+ */
+int clru_cache_get(clru_cache* c, void const* key, void* value);
+
+/** Store a copy of a value under a key
+ *
+ * Evicts the least recently used entry of the key's shard if that shard is
+ * full.
+ */
+void clru_cache_put(clru_cache* c, void const* key, void const* value);
+
+/** Remove the entry of a key
+ *
+ * @returns 1 if the key was cached, 0 otherwise
+ */
+int clru_cache_remove(clru_cache* c, void const* key);
+
+/** Get the counters summed over all shards */
+lru_stats clru_cache_stats(clru_cache* c);
+
+#endif
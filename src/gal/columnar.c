@@ -0,0 +1,292 @@
+#include "columnar.h"
+#include <assert.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define COLUMNAR_INITIAL_CAPACITY 16
+
+/* Allocates an aligned column; aligned_alloc wants a multiple of the
+ * alignment */
+static void* columnar_alloc_column(size_t bytes) {
+  size_t mask = COLUMNAR_ALIGNMENT - 1;
+  size_t rounded = bytes ? (bytes + mask) & ~mask : COLUMNAR_ALIGNMENT;
+  return aligned_alloc(COLUMNAR_ALIGNMENT, rounded);
+}
+
+/* Size of the widest field */
+static size_t columnar_max_field(columnar* c) {
+  size_t max = 0;
+  for (size_t f = 0; f < c->_nfields; ++f) {
+    if (c->_fields[f].size > max)
+      max = c->_fields[f].size;
+  }
+  return max;
+}
+
+columnar* columnar_init(columnar_field const* fields, size_t nfields,
+                        size_t row_size) {
+  assert(nfields > 0 && nfields <= COLUMNAR_MAX_FIELDS && "columnar_init");
+
+  columnar* c = malloc(sizeof(columnar));
+  if (!c)
+    return NULL;
+
+  c->_nfields = nfields;
+  c->_row_size = row_size;
+  c->_size = 0;
+  c->_capacity = 0;
+  for (size_t f = 0; f < nfields; ++f) {
+    assert(fields[f].size > 0 &&
+           fields[f].offset + fields[f].size <= row_size && "columnar_init");
+    c->_fields[f] = fields[f];
+    c->_columns[f] = NULL;
+  }
+
+  if (columnar_reserve(c, COLUMNAR_INITIAL_CAPACITY) != 0) {
+    free(c);
+    return NULL;
+  }
+
+  return c;
+}
+
+void columnar_deinit(columnar* c) {
+  for (size_t f = 0; f < c->_nfields; ++f) {
+    free(c->_columns[f]);
+  }
+  free(c);
+}
+
+size_t columnar_size(columnar* c) { return c->_size; }
+
+int columnar_reserve(columnar* c, size_t capacity) {
+  if (capacity <= c->_capacity)
+    return 0;
+  if (capacity > SIZE_MAX / columnar_max_field(c)) {
+    errno = ENOMEM;
+    return -1;
+  }
+
+  /* All columns are allocated before any is replaced, so a failure leaves
+   * the vector unchanged */
+  void* columns[COLUMNAR_MAX_FIELDS];
+  for (size_t f = 0; f < c->_nfields; ++f) {
+    columns[f] = columnar_alloc_column(capacity * c->_fields[f].size);
+    if (!columns[f]) {
+      while (f-- > 0) {
+        free(columns[f]);
+      }
+      errno = ENOMEM;
+      return -1;
+    }
+  }
+
+  for (size_t f = 0; f < c->_nfields; ++f) {
+    if (c->_size > 0)
+      memcpy(columns[f], c->_columns[f], c->_size * c->_fields[f].size);
+    free(c->_columns[f]);
+    c->_columns[f] = columns[f];
+  }
+  c->_capacity = capacity;
+
+  return 0;
+}
+
+/* Makes room for n more records with at most one resize */
+static int columnar_grow(columnar* c, size_t n) {
+  if (n > SIZE_MAX - c->_size) {
+    errno = ENOMEM;
+    return -1;
+  }
+  if (c->_size + n <= c->_capacity)
+    return 0;
+
+  size_t capacity = c->_capacity * 2;
+  if (capacity < c->_size + n)
+    capacity = c->_size + n;
+  return columnar_reserve(c, capacity);
+}
+
+void columnar_set_row(columnar* c, size_t index, void const* row) {
+  char const* src = row;
+  for (size_t f = 0; f < c->_nfields; ++f) {
+    memcpy(columnar_at(c, f, index), src + c->_fields[f].offset,
+           c->_fields[f].size);
+  }
+}
+
+void columnar_get_row(columnar* c, size_t index, void* row) {
+  assert(index < c->_size && "columnar_get_row");
+
+  char* dest = row;
+  for (size_t f = 0; f < c->_nfields; ++f) {
+    memcpy(dest + c->_fields[f].offset, columnar_at(c, f, index),
+           c->_fields[f].size);
+  }
+}
+
+int columnar_push_row(columnar* c, void const* row) {
+  if (columnar_grow(c, 1) != 0)
+    return -1;
+
+  columnar_set_row(c, c->_size, row);
+  c->_size += 1;
+  return 0;
+}
+
+int columnar_push_rows(columnar* c, void const* rows, size_t n) {
+  if (columnar_grow(c, n) != 0)
+    return -1;
+
+  /* Column by column, so that each column is written sequentially */
+  char const* src = rows;
+  for (size_t f = 0; f < c->_nfields; ++f) {
+    size_t size = c->_fields[f].size;
+    char* dest = columnar_at(c, f, c->_size);
+    char const* field = src + c->_fields[f].offset;
+    for (size_t i = 0; i < n; ++i) {
+      memcpy(dest + i * size, field + i * c->_row_size, size);
+    }
+  }
+  c->_size += n;
+
+  return 0;
+}
+
+void columnar_gather(columnar* c, size_t first, size_t n, void* rows) {
+  assert(first <= c->_size && n <= c->_size - first && "columnar_gather");
+
+  char* dest = rows;
+  for (size_t f = 0; f < c->_nfields; ++f) {
+    size_t size = c->_fields[f].size;
+    char const* src = columnar_at(c, f, first);
+    char* field = dest + c->_fields[f].offset;
+    for (size_t i = 0; i < n; ++i) {
+      memcpy(field + i * c->_row_size, src + i * size, size);
+    }
+  }
+}
+
+size_t columnar_find(columnar* c, size_t field,
+                     int (*predicate)(void const*)) {
+  assert(field < c->_nfields && "columnar_find");
+
+  size_t size = c->_fields[field].size;
+  char const* value = c->_columns[field];
+  for (size_t i = 0; i < c->_size; ++i, value += size) {
+    if (predicate(value))
+      return i;
+  }
+  return VECTOR_NPOS;
+}
+
+size_t columnar_bsearch(columnar* c, size_t field, void const* key,
+                        int (*cmp)(void const*, void const*)) {
+  assert(field < c->_nfields && "columnar_bsearch");
+
+  size_t start = 0, end = c->_size;
+  while (start < end) {
+    size_t mid = start + ((end - start) >> 1);
+    int compare = cmp(key, columnar_at(c, field, mid));
+    if (compare > 0)
+      start = mid + 1;
+    else if (compare < 0)
+      end = mid;
+    else
+      return mid;
+  }
+
+  return VECTOR_NPOS;
+}
+
+/* Bottom-up merge sort of record indices by one column. Returns the array
+ * holding the result, which is either `perm` or `tmp`. */
+static size_t* columnar_sort_indices(size_t* perm, size_t* tmp, size_t n,
+                                     char const* column, size_t size,
+                                     int (*cmp)(void const*, void const*)) {
+  for (size_t width = 1; width < n; width *= 2) {
+    for (size_t left = 0; left < n; left += 2 * width) {
+      size_t mid = left + width < n ? left + width : n;
+      size_t right = mid + width < n ? mid + width : n;
+      size_t i = left, j = mid, k = left;
+
+      while (i < mid && j < right) {
+        /* <= keeps equal records in order */
+        if (cmp(column + perm[i] * size, column + perm[j] * size) <= 0)
+          tmp[k++] = perm[i++];
+        else
+          tmp[k++] = perm[j++];
+      }
+      while (i < mid) {
+        tmp[k++] = perm[i++];
+      }
+      while (j < right) {
+        tmp[k++] = perm[j++];
+      }
+    }
+
+    size_t* swap = perm;
+    perm = tmp;
+    tmp = swap;
+  }
+
+  return perm;
+}
+
+int columnar_sort_by(columnar* c, size_t field,
+                     int (*cmp)(void const*, void const*)) {
+  assert(field < c->_nfields && "columnar_sort_by");
+
+  size_t n = c->_size;
+  if (n < 2)
+    return 0;
+
+  size_t* indices = malloc(2 * n * sizeof(size_t));
+  void* spare = columnar_alloc_column(c->_capacity * columnar_max_field(c));
+  if (!indices || !spare) {
+    free(indices);
+    free(spare);
+    errno = ENOMEM;
+    return -1;
+  }
+
+  for (size_t i = 0; i < n; ++i) {
+    indices[i] = i;
+  }
+  size_t* perm =
+      columnar_sort_indices(indices, indices + n, n, c->_columns[field],
+                            c->_fields[field].size, cmp);
+
+  /* Fields from the widest to the narrowest */
+  size_t order[COLUMNAR_MAX_FIELDS];
+  for (size_t f = 0; f < c->_nfields; ++f) {
+    size_t j = f;
+    for (; j > 0 && c->_fields[order[j - 1]].size < c->_fields[f].size; --j) {
+      order[j] = order[j - 1];
+    }
+    order[j] = f;
+  }
+
+  /* Every column is gathered into the spare buffer, which then takes its
+   * place; the old column becomes the spare for the next one. The first
+   * spare fits the widest field and columns get narrower, so each spare is
+   * large enough. */
+  for (size_t k = 0; k < c->_nfields; ++k) {
+    size_t f = order[k];
+    size_t size = c->_fields[f].size;
+    char const* src = c->_columns[f];
+    char* dest = spare;
+    for (size_t i = 0; i < n; ++i) {
+      memcpy(dest + i * size, src + perm[i] * size, size);
+    }
+
+    spare = c->_columns[f];
+    c->_columns[f] = dest;
+  }
+
+  free(spare);
+  free(indices);
+  return 0;
+}
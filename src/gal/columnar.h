@@ -0,0 +1,160 @@
+/** columnar.h - struct-of-arrays vector for multi-field records */
+
+#ifndef GAL_COLUMNAR_H
+#define GAL_COLUMNAR_H
+
+#include <stddef.h>
+
+#include "platform.h"
+#include "vector.h"
+
+/** Maximum number of fields of a record */
+#define COLUMNAR_MAX_FIELDS 16
+
+/** Alignment of every column */
+#define COLUMNAR_ALIGNMENT GAL_CACHE_LINE_SIZE
+
+/** Field of a record
+ *
+ * @field size
+ * Size of the field
+ *
+ * @field offset
+ * Offset of the field in the row form of a record
+ */
+typedef struct {
+  size_t size;
+  size_t offset;
+} columnar_field;
+
+/** Describe a member of a struct as a field */
+#define COLUMNAR_FIELD(type, member)                                           \
+  { sizeof(((type*)0)->member), offsetof(type, member) }
+
+/** Vector of records that stores each field in its own array
+ *
+ * Records are added and read in row form, a struct described by the field
+ * descriptors, and stored column by column. A scan or sort over one field
+ * touches only that field's column, so it moves a fraction of the memory a
+ * `vector` of the same records would. Every column is aligned to
+ * COLUMNAR_ALIGNMENT.
+ *
+ * @field _columns
+ * Array of each field, all with the same capacity
+ *
+ * @field _row_size
+ * Size of a record in row form
+ */
+typedef struct {
+  size_t _nfields;
+  size_t _row_size;
+  size_t _size;
+  size_t _capacity;
+  columnar_field _fields[COLUMNAR_MAX_FIELDS];
+  void* _columns[COLUMNAR_MAX_FIELDS];
+} columnar;
+
+/** Create a columnar vector
+ *
+ * @param fields field descriptors, copied into the vector
+ * @param nfields number of fields, at most COLUMNAR_MAX_FIELDS
+ * @param row_size size of a record in row form
+ * @returns columnar vector or NULL if memory can not be allocated
+ */
+columnar* columnar_init(columnar_field const* fields, size_t nfields,
+                        size_t row_size);
+
+/** Destroy a columnar vector */
+void columnar_deinit(columnar* c);
+
+/** Get the number of records */
+size_t columnar_size(columnar* c);
+
+/** Make room for at least `capacity` records
+ *
+ * Returns 0 on success and -1 with errno set to ENOMEM on failure, in which
+ * case the vector is left unchanged.
+ *
+ * Complexity: O(n) if the columns are resized
+ */
+int columnar_reserve(columnar* c, size_t capacity);
+
+/** Get the array of a field
+ *
+ * The pointer is invalidated when the vector is resized or sorted.
+ */
+static inline void* columnar_column(columnar* c, size_t field) {
+  return c->_columns[field];
+}
+
+/** Get a field of a record without bounds checking */
+static inline void* columnar_at(columnar* c, size_t field, size_t index) {
+  return (char*)c->_columns[field] + index * c->_fields[field].size;
+}
+
+/** Add a record given in row form
+ *
+ * Scatters the fields of `row` into the columns.
+ *
+ * Returns 0 on success and -1 with errno set to ENOMEM on failure.
+ *
+ * Complexity: O(1) amortized
+ */
+int columnar_push_row(columnar* c, void const* row);
+
+/** Add n contiguous records given in row form
+ *
+ * Resizes the columns at most once.
+ *
+ * Returns 0 on success and -1 with errno set to ENOMEM on failure.
+ */
+int columnar_push_rows(columnar* c, void const* rows, size_t n);
+
+/** Copy a record into row form
+ *
+ * Bytes of `row` that belong to no field are left untouched.
+ */
+void columnar_get_row(columnar* c, size_t index, void* row);
+
+/** Overwrite a record with one given in row form */
+void columnar_set_row(columnar* c, size_t index, void const* row);
+
+/** Copy n records starting at `first` into contiguous row form */
+void columnar_gather(columnar* c, size_t first, size_t n, void* rows);
+
+/** Return the index of the first record whose field satisfies a predicate
+ *
+ * Only the column of the field is read. If there is no such record,
+ * VECTOR_NPOS is returned.
+ *
+ * Complexity: O(n)
+ */
+size_t columnar_find(columnar* c, size_t field,
+                     int (*predicate)(void const*));
+
+/** Search a field sorted with `columnar_sort_by` using binary search
+ *
+ * The key has the type of the field. Returns the index of a record whose
+ * field equals the key or VECTOR_NPOS if there is none.
+ *
+ * Complexity: O(log n)
+ */
+size_t columnar_bsearch(columnar* c, size_t field, void const* key,
+                        int (*cmp)(void const*, void const*));
+
+/** Sort records by a field
+ *
+ * Computes the sorting permutation over the field's column with a stable
+ * merge sort of indices, then applies it to every column with one gather
+ * per column. Records with equal fields keep their order, so sorting by
+ * several fields in turn orders by the last one first.
+ *
+ * Returns 0 on success and -1 with errno set to ENOMEM on failure, in which
+ * case the vector is left unchanged.
+ *
+ * Complexity: O(n log n) comparisons, O(n * fields) moves
+ */
+int columnar_sort_by(columnar* c, size_t field,
+                     int (*cmp)(void const*, void const*));
+
+#endif
@@ -0,0 +1,255 @@
+#include "cow_vector.h"
+#include <assert.h>
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define COW_VECTOR_MASK (COW_VECTOR_BRANCH - 1)
+
+/* Inner nodes keep COW_VECTOR_BRANCH children in `payload`, leaves keep
+ * COW_VECTOR_BRANCH elements. Which one a node is follows from its depth. */
+typedef struct cow_node {
+  atomic_size_t refs;
+  _Alignas(max_align_t) unsigned char payload[];
+} cow_node;
+
+struct cow_snapshot {
+  atomic_size_t refs;
+  cow_node* root;
+  size_t shift;
+  size_t size;
+  size_t element_size;
+};
+
+struct cow_vector {
+  cow_node* root;
+  size_t shift;
+  size_t size;
+  size_t element_size;
+
+  /* guards `published` against a concurrent acquire */
+  atomic_flag lock;
+  cow_snapshot* published;
+};
+
+static cow_node** cow_children(cow_node* node) {
+  return (cow_node**)node->payload;
+}
+
+static size_t cow_node_bytes(size_t shift, size_t element_size) {
+  size_t slot = shift > 0 ? sizeof(cow_node*) : element_size;
+  return sizeof(cow_node) + COW_VECTOR_BRANCH * slot;
+}
+
+static cow_node* cow_node_alloc(size_t shift, size_t element_size) {
+  cow_node* node = malloc(cow_node_bytes(shift, element_size));
+  if (!node)
+    return NULL;
+
+  atomic_init(&node->refs, 1);
+  if (shift > 0) {
+    for (size_t i = 0; i < COW_VECTOR_BRANCH; ++i) {
+      cow_children(node)[i] = NULL;
+    }
+  }
+  return node;
+}
+
+static void cow_node_retain(cow_node* node) {
+  if (node)
+    atomic_fetch_add_explicit(&node->refs, 1, memory_order_relaxed);
+}
+
+static void cow_node_release(cow_node* node, size_t shift) {
+  if (!node ||
+      atomic_fetch_sub_explicit(&node->refs, 1, memory_order_acq_rel) != 1)
+    return;
+
+  if (shift > 0) {
+    for (size_t i = 0; i < COW_VECTOR_BRANCH; ++i) {
+      cow_node_release(cow_children(node)[i], shift - COW_VECTOR_BITS);
+    }
+  }
+  free(node);
+}
+
+/* Makes the node in `slot` exclusively owned by the caller, creating it if
+ * it is missing and copying it if it is shared */
+static cow_node* cow_node_writable(cow_node** slot, size_t shift,
+                                   size_t element_size) {
+  cow_node* node = *slot;
+  if (!node)
+    return *slot = cow_node_alloc(shift, element_size);
+  if (atomic_load_explicit(&node->refs, memory_order_acquire) == 1)
+    return node;
+
+  cow_node* copy = malloc(cow_node_bytes(shift, element_size));
+  if (!copy)
+    return NULL;
+
+  atomic_init(&copy->refs, 1);
+  memcpy(copy->payload, node->payload,
+         cow_node_bytes(shift, element_size) - sizeof(cow_node));
+  if (shift > 0) {
+    for (size_t i = 0; i < COW_VECTOR_BRANCH; ++i) {
+      cow_node_retain(cow_children(copy)[i]);
+    }
+  }
+
+  cow_node_release(node, shift);
+  return *slot = copy;
+}
+
+static void const* cow_lookup(cow_node* node, size_t shift, size_t index,
+                              size_t element_size) {
+  for (; shift > 0; shift -= COW_VECTOR_BITS) {
+    node = cow_children(node)[(index >> shift) & COW_VECTOR_MASK];
+  }
+  return node->payload + (index & COW_VECTOR_MASK) * element_size;
+}
+
+static cow_snapshot* cow_snapshot_create(cow_vector* v) {
+  cow_snapshot* s = malloc(sizeof(cow_snapshot));
+  if (!s)
+    return NULL;
+
+  atomic_init(&s->refs, 1);
+  cow_node_retain(v->root);
+  s->root = v->root;
+  s->shift = v->shift;
+  s->size = v->size;
+  s->element_size = v->element_size;
+  return s;
+}
+
+cow_vector* cow_vector_init(size_t element_size) {
+  assert(element_size > 0 && "cow_vector_init");
+
+  cow_vector* v = malloc(sizeof(cow_vector));
+  if (!v)
+    return NULL;
+
+  v->root = NULL;
+  v->shift = 0;
+  v->size = 0;
+  v->element_size = element_size;
+  atomic_flag_clear(&v->lock);
+
+  v->published = cow_snapshot_create(v);
+  if (!v->published) {
+    free(v);
+    return NULL;
+  }
+
+  return v;
+}
+
+void cow_vector_deinit(cow_vector* v) {
+  cow_snapshot_release(v->published);
+  cow_node_release(v->root, v->shift);
+  free(v);
+}
+
+size_t cow_vector_size(cow_vector* v) { return v->size; }
+
+void const* cow_vector_at(cow_vector* v, size_t index) {
+  assert(index < v->size && "cow_vector_at");
+  return cow_lookup(v->root, v->shift, index, v->element_size);
+}
+
+/* Copies the path to `index` where it is shared and returns the slot of the
+ * element, or NULL if memory can not be allocated. Nodes copied before a
+ * failure hold the same contents, so the vector is unchanged. */
+static void* cow_vector_slot(cow_vector* v, size_t index) {
+  cow_node** slot = &v->root;
+  for (size_t shift = v->shift;; shift -= COW_VECTOR_BITS) {
+    cow_node* node = cow_node_writable(slot, shift, v->element_size);
+    if (!node)
+      return NULL;
+    if (shift == 0)
+      return node->payload + (index & COW_VECTOR_MASK) * v->element_size;
+    slot = &cow_children(node)[(index >> shift) & COW_VECTOR_MASK];
+  }
+}
+
+int cow_vector_push(cow_vector* v, void const* item) {
+  /* A full tree gets a new root with the old one as its first child */
+  if (v->root && v->size == (size_t)COW_VECTOR_BRANCH << v->shift) {
+    cow_node* root = cow_node_alloc(v->shift + COW_VECTOR_BITS, 0);
+    if (!root) {
+      errno = ENOMEM;
+      return -1;
+    }
+    cow_children(root)[0] = v->root;
+    v->root = root;
+    v->shift += COW_VECTOR_BITS;
+  }
+
+  void* slot = cow_vector_slot(v, v->size);
+  if (!slot) {
+    errno = ENOMEM;
+    return -1;
+  }
+
+  memcpy(slot, item, v->element_size);
+  v->size += 1;
+  return 0;
+}
+
+int cow_vector_replace(cow_vector* v, size_t index, void const* item) {
+  assert(index < v->size && "cow_vector_replace");
+
+  void* slot = cow_vector_slot(v, index);
+  if (!slot) {
+    errno = ENOMEM;
+    return -1;
+  }
+
+  memcpy(slot, item, v->element_size);
+  return 0;
+}
+
+cow_snapshot* cow_vector_snapshot(cow_vector* v) {
+  return cow_snapshot_create(v);
+}
+
+int cow_vector_publish(cow_vector* v) {
+  cow_snapshot* s = cow_snapshot_create(v);
+  if (!s)
+    return -1;
+
+  while (atomic_flag_test_and_set_explicit(&v->lock, memory_order_acquire)) {
+  }
+  cow_snapshot* old = v->published;
+  v->published = s;
+  atomic_flag_clear_explicit(&v->lock, memory_order_release);
+
+  cow_snapshot_release(old);
+  return 0;
+}
+
+cow_snapshot* cow_vector_acquire(cow_vector* v) {
+  while (atomic_flag_test_and_set_explicit(&v->lock, memory_order_acquire)) {
+  }
+  cow_snapshot* s = v->published;
+  atomic_fetch_add_explicit(&s->refs, 1, memory_order_relaxed);
+  atomic_flag_clear_explicit(&v->lock, memory_order_release);
+
+  return s;
+}
+
+void cow_snapshot_release(cow_snapshot* s) {
+  if (atomic_fetch_sub_explicit(&s->refs, 1, memory_order_acq_rel) != 1)
+    return;
+
+  cow_node_release(s->root, s->shift);
+  free(s);
+}
+
+size_t cow_snapshot_size(cow_snapshot* s) { return s->size; }
+
+void const* cow_snapshot_at(cow_snapshot* s, size_t index) {
+  assert(index < s->size && "cow_snapshot_at");
+  return cow_lookup(s->root, s->shift, index, s->element_size);
+}
@@ -0,0 +1,124 @@
+/** cow_vector.h - persistent vector with O(1) snapshots */
+
+#ifndef GAL_COW_VECTOR_H
+#define GAL_COW_VECTOR_H
+
+#include <stddef.h>
+
+/** Number of bits of an index consumed by one level of the tree */
+#define COW_VECTOR_BITS 5
+
+/** Number of children of an inner node and of elements in a leaf */
+#define COW_VECTOR_BRANCH (1 << COW_VECTOR_BITS)
+
+/** Copy-on-write vector
+ *
+ * Elements are stored in leaves of COW_VECTOR_BRANCH elements, which hang
+ * off a radix tree of inner nodes with COW_VECTOR_BRANCH children each.
+ * Every node has a reference count. Taking a snapshot only references the
+ * root, so it is O(1). A write then copies just the nodes on the path to the
+ * element that are shared with a snapshot; all other nodes stay shared.
+ * Nodes owned by the vector alone are modified in place. When a snapshot is
+ * released, nodes that no one references any more are freed.
+ *
+ * A vector has a single writer. Readers work with snapshots, which are
+ * immutable and may be read by any number of threads. There are two ways to
+ * get a snapshot:
+ *     - the writer calls `cow_vector_snapshot` and hands the result over;
+ *     - the writer calls `cow_vector_publish` whenever readers should see
+ *       the current contents, and any thread calls `cow_vector_acquire` to
+ *       get the last published snapshot.
+ *
+ * Complexity of access and update: O(log n) with base COW_VECTOR_BRANCH
+ */
+typedef struct cow_vector cow_vector;
+
+/** Immutable version of a `cow_vector` */
+typedef struct cow_snapshot cow_snapshot;
+
+/** Create a copy-on-write vector
+ *
+ * Returns NULL if memory can not be allocated.
+ */
+cow_vector* cow_vector_init(size_t element_size);
+
+/** Destroy a copy-on-write vector
+ *
+ * Snapshots taken from the vector stay valid until they are released.
+ */
+void cow_vector_deinit(cow_vector* v);
+
+/** Get the size of a vector */
+size_t cow_vector_size(cow_vector* v);
+
+/** Get an element at index
+ *
+ * The pointer is read-only and is invalidated by the next update of the
+ * vector. Terminates program if index >= size.
+ */
+void const* cow_vector_at(cow_vector* v, size_t index);
+
+/** Add element to the end of a vector
+ *
+ * Returns 0 on success and -1 with errno set to ENOMEM on failure, in which
+ * case the contents of the vector are unchanged.
+ *
+ * Complexity: O(log n), plus copying the shared nodes on the path
+ */
+int cow_vector_push(cow_vector* v, void const* item);
+
+/** Replace element at index
+ *
+ * Returns 0 on success and -1 with errno set to ENOMEM on failure, in which
+ * case the contents of the vector are unchanged.
+ *
+ * Complexity: O(log n), plus copying the shared nodes on the path
+ */
+int cow_vector_replace(cow_vector* v, size_t index, void const* item);
+
+/** Take a snapshot of the current contents
+ *
+ * Must be called by the writer. Returns NULL if memory can not be
+ * allocated.
+ *
+ * Complexity: O(1)
+ */
+cow_snapshot* cow_vector_snapshot(cow_vector* v);
+
+/** Make the current contents the version returned by `cow_vector_acquire`
+ *
+ * Must be called by the writer. The previously published snapshot is
+ * released. Returns 0 on success and -1 with errno set to ENOMEM on failure.
+ *
+ * Complexity: O(1)
+ */
+int cow_vector_publish(cow_vector* v);
+
+/** Get the last published snapshot
+ *
+ * May be called by any thread, concurrently with the writer. Before the
+ * first `cow_vector_publish`, returns a snapshot of the empty vector.
+ *
+ * Complexity: O(1)
+ */
+cow_snapshot* cow_vector_acquire(cow_vector* v);
+
+/** Release a snapshot
+ *
+ * May be called by any thread.
+ */
+void cow_snapshot_release(cow_snapshot* s);
+
+/** Get the size of a snapshot */
+size_t cow_snapshot_size(cow_snapshot* s);
+
+/** Get an element of a snapshot at index
+ *
+ * The pointer stays valid until the snapshot is released. Terminates program
+ * if index >= size.
+ *
+ * Complexity: O(log n)
+ */
+void const* cow_snapshot_at(cow_snapshot* s, size_t index);
+
+#endif
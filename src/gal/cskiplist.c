@@ -0,0 +1,257 @@
+#include "cskiplist.h"
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct cskiplist_node {
+  atomic_int deleted;
+  size_t height;
+  cskiplist_node* _Atomic next[];
+};
+
+struct cskiplist {
+  size_t element_size;
+  int (*cmp)(void const*, void const*);
+  cskiplist_node* head;
+  /* height of the tallest node ever inserted */
+  atomic_size_t level;
+  atomic_size_t size;
+};
+
+static size_t cskiplist_data_offset(size_t height) {
+  size_t offset = sizeof(cskiplist_node) + height * sizeof(cskiplist_node*);
+  size_t align = _Alignof(max_align_t);
+  return (offset + align - 1) & ~(align - 1);
+}
+
+static void* cskiplist_node_data(cskiplist_node* node) {
+  return (char*)node + cskiplist_data_offset(node->height);
+}
+
+static cskiplist_node* cskiplist_node_alloc(size_t height, size_t data_size) {
+  cskiplist_node* node = malloc(cskiplist_data_offset(height) + data_size);
+  if (!node)
+    return NULL;
+
+  atomic_init(&node->deleted, 0);
+  node->height = height;
+  for (size_t i = 0; i < height; ++i) {
+    atomic_init(&node->next[i], NULL);
+  }
+  return node;
+}
+
+static cskiplist_node* cskiplist_load(cskiplist_node* node, size_t level) {
+  return atomic_load_explicit(&node->next[level], memory_order_acquire);
+}
+
+/* Same distribution as `skiplist`, from a generator per thread */
+static size_t cskiplist_random_height(void) {
+  static _Thread_local uint64_t state;
+  if (state == 0)
+    state = 0x2545f4914f6cdd1dull ^ (uintptr_t)&state;
+
+  uint64_t x = state;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  state = x;
+
+  size_t height = 1;
+  while (height < SKIPLIST_MAX_LEVEL && (x & 3) == 0) {
+    height += 1;
+    x >>= 2;
+  }
+  return height;
+}
+
+/* Fills `preds` and `succs` with the nodes around the key on the lowest
+ * `top` levels and returns the first node that is not less than the key */
+static cskiplist_node* cskiplist_search(cskiplist* sl, void const* key,
+                                        size_t top, cskiplist_node** preds,
+                                        cskiplist_node** succs) {
+  size_t level = atomic_load_explicit(&sl->level, memory_order_relaxed);
+  if (level < top)
+    level = top;
+
+  cskiplist_node* x = sl->head;
+  cskiplist_node* next = NULL;
+  while (level-- > 0) {
+    next = cskiplist_load(x, level);
+    while (next && sl->cmp(cskiplist_node_data(next), key) < 0) {
+      x = next;
+      next = cskiplist_load(x, level);
+    }
+    if (level < top) {
+      preds[level] = x;
+      succs[level] = next;
+    }
+  }
+  return next;
+}
+
+/* Returns the live node among those equal to the key starting at `node` */
+static cskiplist_node* cskiplist_live(cskiplist* sl, cskiplist_node* node,
+                                      void const* key) {
+  for (; node && sl->cmp(cskiplist_node_data(node), key) == 0;
+       node = cskiplist_load(node, 0)) {
+    if (!atomic_load_explicit(&node->deleted, memory_order_acquire))
+      return node;
+  }
+  return NULL;
+}
+
+cskiplist* cskiplist_init(size_t element_size,
+                          int (*cmp)(void const*, void const*)) {
+  cskiplist* sl = malloc(sizeof(cskiplist));
+  if (!sl)
+    return NULL;
+
+  sl->head = cskiplist_node_alloc(SKIPLIST_MAX_LEVEL, 0);
+  if (!sl->head) {
+    free(sl);
+    return NULL;
+  }
+
+  sl->element_size = element_size;
+  sl->cmp = cmp;
+  atomic_init(&sl->level, 1);
+  atomic_init(&sl->size, 0);
+  return sl;
+}
+
+void cskiplist_deinit(cskiplist* sl) {
+  cskiplist_node* node = sl->head;
+  while (node) {
+    cskiplist_node* next = atomic_load_explicit(&node->next[0],
+                                                memory_order_relaxed);
+    free(node);
+    node = next;
+  }
+  free(sl);
+}
+
+size_t cskiplist_size(cskiplist* sl) {
+  return atomic_load_explicit(&sl->size, memory_order_relaxed);
+}
+
+int cskiplist_insert(cskiplist* sl, void const* item) {
+  cskiplist_node* preds[SKIPLIST_MAX_LEVEL];
+  cskiplist_node* succs[SKIPLIST_MAX_LEVEL];
+
+  size_t height = cskiplist_random_height();
+  cskiplist_node* node = cskiplist_node_alloc(height, sl->element_size);
+  if (!node) {
+    errno = ENOMEM;
+    return -1;
+  }
+  memcpy(cskiplist_node_data(node), item, sl->element_size);
+
+  /* Linking into level 0 publishes the node; the CAS fails if another node
+   * was linked after the predecessor since the search */
+  for (;;) {
+    cskiplist_node* succ = cskiplist_search(sl, item, height, preds, succs);
+    if (cskiplist_live(sl, succ, item)) {
+      free(node);
+      return 0;
+    }
+
+    for (size_t level = 0; level < height; ++level) {
+      atomic_store_explicit(&node->next[level], succs[level],
+                            memory_order_relaxed);
+    }
+    if (atomic_compare_exchange_strong_explicit(
+            &preds[0]->next[0], &succs[0], node, memory_order_release,
+            memory_order_relaxed))
+      break;
+  }
+  atomic_fetch_add_explicit(&sl->size, 1, memory_order_relaxed);
+
+  size_t level = atomic_load_explicit(&sl->level, memory_order_relaxed);
+  while (level < height &&
+         !atomic_compare_exchange_weak_explicit(
+             &sl->level, &level, height, memory_order_relaxed,
+             memory_order_relaxed)) {
+  }
+
+  /* Express lanes are only shortcuts, so they may lag behind level 0 */
+  for (size_t level = 1; level < height; ++level) {
+    while (!atomic_compare_exchange_strong_explicit(
+        &preds[level]->next[level], &succs[level], node, memory_order_release,
+        memory_order_relaxed)) {
+      cskiplist_search(sl, item, height, preds, succs);
+      atomic_store_explicit(&node->next[level], succs[level],
+                            memory_order_relaxed);
+    }
+  }
+
+  return 1;
+}
+
+int cskiplist_remove(cskiplist* sl, void const* key) {
+  cskiplist_node* preds[1];
+  cskiplist_node* succs[1];
+  cskiplist_node* node = cskiplist_search(sl, key, 1, preds, succs);
+
+  while ((node = cskiplist_live(sl, node, key))) {
+    int expected = 0;
+    if (atomic_compare_exchange_strong_explicit(&node->deleted, &expected, 1,
+                                                memory_order_acq_rel,
+                                                memory_order_relaxed)) {
+      atomic_fetch_sub_explicit(&sl->size, 1, memory_order_relaxed);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+void const* cskiplist_find(cskiplist* sl, void const* key) {
+  cskiplist_node* preds[1];
+  cskiplist_node* succs[1];
+  cskiplist_node* node =
+      cskiplist_live(sl, cskiplist_search(sl, key, 1, preds, succs), key);
+  return node ? cskiplist_node_data(node) : NULL;
+}
+
+static cskiplist_node* cskiplist_skip_deleted(cskiplist_node* node) {
+  while (node && atomic_load_explicit(&node->deleted, memory_order_acquire)) {
+    node = cskiplist_load(node, 0);
+  }
+  return node;
+}
+
+cskiplist_node* cskiplist_first(cskiplist* sl) {
+  return cskiplist_skip_deleted(cskiplist_load(sl->head, 0));
+}
+
+cskiplist_node* cskiplist_next(cskiplist_node* node) {
+  return cskiplist_skip_deleted(cskiplist_load(node, 0));
+}
+
+void const* cskiplist_data(cskiplist_node* node) {
+  return cskiplist_node_data(node);
+}
+
+void cskiplist_compact(cskiplist* sl) {
+  size_t top = atomic_load_explicit(&sl->level, memory_order_relaxed);
+
+  /* Unlink from the express lanes first; a node is freed once it is gone
+   * from level 0 */
+  for (size_t level = top; level-- > 0;) {
+    cskiplist_node* prev = sl->head;
+    cskiplist_node* node = cskiplist_load(prev, level);
+    while (node) {
+      cskiplist_node* next = cskiplist_load(node, level);
+      if (atomic_load_explicit(&node->deleted, memory_order_relaxed)) {
+        atomic_store_explicit(&prev->next[level], next, memory_order_relaxed);
+        if (level == 0)
+          free(node);
+      } else {
+        prev = node;
+      }
+      node = next;
+    }
+  }
+}
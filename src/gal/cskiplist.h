@@ -0,0 +1,96 @@
+/** cskiplist.h - skip list with lock-free insertion and lookup */
+
+#ifndef GAL_CSKIPLIST_H
+#define GAL_CSKIPLIST_H
+
+#include <stddef.h>
+
+#include "skiplist.h"
+
+/** Ordered set that many threads can update at once
+ *
+ * A concurrent variant of `skiplist`. Nodes are linked bottom-up with
+ * compare-and-swap: an insertion takes effect when it is linked into
+ * level 0, and the express lanes are added afterwards. Removal is logical:
+ * it marks the node deleted with a compare-and-swap, and the node stays
+ * linked so that no reader can observe freed memory. A key that is removed
+ * and inserted again gets a new node in front of the deleted one.
+ *
+ * Deleted nodes are freed by `cskiplist_compact` or `cskiplist_deinit`,
+ * which must not run concurrently with other operations. Insert-mostly
+ * workloads therefore fit best.
+ *
+ * Level 0 is singly linked; unlike `skiplist` there is no reverse
+ * iteration.
+ */
+typedef struct cskiplist cskiplist;
+
+/** Node of a concurrent skip list */
+typedef struct cskiplist_node cskiplist_node;
+
+/** Create a concurrent skip list
+ *
+ * Comparison function has the same contract as for `skiplist_init`.
+ *
+ * Returns NULL if memory can not be allocated.
+ */
+cskiplist* cskiplist_init(size_t element_size,
+                          int (*cmp)(void const*, void const*));
+
+/** Destroy a concurrent skip list
+ *
+ * Must not run concurrently with any other operation.
+ */
+void cskiplist_deinit(cskiplist* sl);
+
+/** Get the number of elements that are not deleted
+ *
+ * Exact only when no update is in progress.
+ */
+size_t cskiplist_size(cskiplist* sl);
+
+/** Insert an element
+ *
+ * Lock-free. Returns 1 if the element was inserted, 0 if an equal element
+ * is present, and -1 with errno set to ENOMEM if memory can not be
+ * allocated.
+ *
+ * Complexity: expected O(log n), plus the deleted nodes with an equal key
+ */
+int cskiplist_insert(cskiplist* sl, void const* item);
+
+/** Remove the element equal to the key
+ *
+ * Lock-free. Marks the node deleted and returns 1, or returns 0 if there is
+ * no such element.
+ */
+int cskiplist_remove(cskiplist* sl, void const* key);
+
+/** Find the element equal to the key
+ *
+ * Wait-free with respect to other threads. Returns a pointer to the stored
+ * element, which stays valid until the next `cskiplist_compact`, or NULL if
+ * there is none.
+ *
+ * Complexity: expected O(log n)
+ */
+void const* cskiplist_find(cskiplist* sl, void const* key);
+
+/** Get the first node that is not deleted, or NULL */
+cskiplist_node* cskiplist_first(cskiplist* sl);
+
+/** Get the next node in order that is not deleted, or NULL */
+cskiplist_node* cskiplist_next(cskiplist_node* node);
+
+/** Get the element of a node */
+void const* cskiplist_data(cskiplist_node* node);
+
+/** Free all deleted nodes
+ *
+ * Must not run concurrently with any other operation.
+ *
+ * Complexity: O(n)
+ */
+void cskiplist_compact(cskiplist* sl);
+
+#endif
@@ -0,0 +1,149 @@
+#include "cvector.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+cvector* cvector_init(size_t element_size) {
+  cvector* cv = (cvector*)aligned_alloc(_Alignof(cvector), sizeof(cvector));
+  if (!cv)
+    return NULL;
+
+  cv->_element_size = element_size;
+  atomic_init(&cv->_size, 0);
+  for (size_t k = 0; k < CVECTOR_SEGMENTS; ++k) {
+    atomic_init(&cv->_segments[k], NULL);
+  }
+
+  return cv;
+}
+
+void cvector_deinit(cvector* cv) {
+  for (size_t k = 0; k < CVECTOR_SEGMENTS; ++k) {
+    free(atomic_load_explicit(&cv->_segments[k], memory_order_relaxed));
+  }
+  free(cv);
+}
+
+size_t cvector_size(cvector* cv) {
+  return atomic_load_explicit(&cv->_size, memory_order_acquire);
+}
+
+static size_t cvector_segment_length(size_t segment) {
+  return (size_t)CVECTOR_FIRST_SEGMENT << segment;
+}
+
+/* Index of the first element of a segment */
+static size_t cvector_segment_start(size_t segment) {
+  return CVECTOR_FIRST_SEGMENT * (((size_t)1 << segment) - 1);
+}
+
+static size_t cvector_segment_of(size_t index) {
+  size_t s = index / CVECTOR_FIRST_SEGMENT + 1;
+  return sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(s);
+}
+
+/* Returns the segment, allocating and publishing it if no other writer has
+ * done that yet. */
+static char* cvector_segment(cvector* cv, size_t segment) {
+  void* data =
+      atomic_load_explicit(&cv->_segments[segment], memory_order_acquire);
+  if (data)
+    return data;
+
+  /* The slot is already reserved, so there is no way to back out */
+  void* fresh = malloc(cvector_segment_length(segment) * cv->_element_size);
+  if (!fresh) {
+    fprintf(stderr, "cvector_push: out of memory\n");
+    abort();
+  }
+
+  void* expected = NULL;
+  if (atomic_compare_exchange_strong_explicit(&cv->_segments[segment],
+                                              &expected, fresh,
+                                              memory_order_acq_rel,
+                                              memory_order_acquire)) {
+    return fresh;
+  }
+
+  free(fresh);
+  return expected;
+}
+
+size_t cvector_push(cvector* cv, void const* item) {
+  size_t index =
+      atomic_fetch_add_explicit(&cv->_size, 1, memory_order_relaxed);
+  size_t segment = cvector_segment_of(index);
+  assert(segment < CVECTOR_SEGMENTS && "cvector_push");
+
+  char* data = cvector_segment(cv, segment);
+  size_t offset = index - cvector_segment_start(segment);
+  memcpy(data + offset * cv->_element_size, item, cv->_element_size);
+
+  return index;
+}
+
+size_t cvector_push_n(cvector* cv, void const* items, size_t n) {
+  size_t first =
+      atomic_fetch_add_explicit(&cv->_size, n, memory_order_relaxed);
+  size_t element_size = cv->_element_size;
+  char const* src = items;
+  size_t index = first;
+
+  while (n > 0) {
+    size_t segment = cvector_segment_of(index);
+    assert(segment < CVECTOR_SEGMENTS && "cvector_push_n");
+
+    size_t offset = index - cvector_segment_start(segment);
+    size_t chunk = cvector_segment_length(segment) - offset;
+    if (chunk > n)
+      chunk = n;
+
+    char* data = cvector_segment(cv, segment);
+    memcpy(data + offset * element_size, src, chunk * element_size);
+
+    src += chunk * element_size;
+    index += chunk;
+    n -= chunk;
+  }
+
+  return first;
+}
+
+void* cvector_at(cvector* cv, size_t index) {
+  assert(index < cvector_size(cv) && "cvector_at");
+
+  size_t segment = cvector_segment_of(index);
+  char* data =
+      atomic_load_explicit(&cv->_segments[segment], memory_order_acquire);
+  size_t offset = index - cvector_segment_start(segment);
+  return data + offset * cv->_element_size;
+}
+
+vector* cvector_freeze(cvector* cv) {
+  size_t size = atomic_load_explicit(&cv->_size, memory_order_relaxed);
+  size_t element_size = cv->_element_size;
+
+  vector* v = vector_init(element_size);
+  if (!v)
+    return NULL;
+  if (vector_try_reserve(v, size) != 0) {
+    vector_deinit(v);
+    return NULL;
+  }
+
+  size_t copied = 0;
+  for (size_t segment = 0; copied < size; ++segment) {
+    size_t chunk = cvector_segment_length(segment);
+    if (chunk > size - copied)
+      chunk = size - copied;
+
+    char* data =
+        atomic_load_explicit(&cv->_segments[segment], memory_order_relaxed);
+    vector_push_n(v, data, chunk);
+    copied += chunk;
+  }
+
+  cvector_deinit(cv);
+  return v;
+}
@@ -0,0 +1,105 @@
+/** cvector.h - append-only vector for concurrent writers */
+
+#ifndef GAL_CVECTOR_H
+#define GAL_CVECTOR_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+#include "platform.h"
+#include "vector.h"
+
+/** Number of elements in the first segment */
+#define CVECTOR_FIRST_SEGMENT 16
+
+/** Maximum number of segments
+ *
+ * Segment k holds CVECTOR_FIRST_SEGMENT << k elements, so this bounds the
+ * total number of elements by CVECTOR_FIRST_SEGMENT * (2^CVECTOR_SEGMENTS - 1).
+ */
+#define CVECTOR_SEGMENTS (sizeof(size_t) * 8 - 4)
+
+/** Append-only vector that many threads can push to at once
+ *
+ * Storage is a fixed table of geometrically growing segments. A push reserves
+ * its slot with an atomic fetch-add and installs a missing segment with a
+ * compare-and-swap, so growth never moves existing elements and no lock is
+ * taken.
+ *
+ * An element may be read by any thread once the push that wrote it has
+ * returned and that fact has been communicated to the reader (for example
+ * through a thread join or an atomic flag). `cvector_size` counts reserved
+ * slots, which may include elements that are still being written.
+ *
+ * @field _size
+ * Number of reserved slots
+ *
+ * @field _segments
+ * Segment table, filled lazily by writers
+ */
+typedef struct {
+  size_t _element_size;
+  _Alignas(GAL_CACHE_LINE_SIZE) atomic_size_t _size;
+  _Alignas(GAL_CACHE_LINE_SIZE) void* _Atomic _segments[CVECTOR_SEGMENTS];
+} cvector;
+
+/** Create a concurrent vector
+ *
+ * Returns NULL if memory can not be allocated.
+ */
+cvector* cvector_init(size_t element_size);
+
+/** Destroy a concurrent vector
+ *
+ * Must not run concurrently with any other operation.
+ */
+void cvector_deinit(cvector* cv);
+
+/** Get the number of reserved slots */
+size_t cvector_size(cvector* cv);
+
+/** Append an element
+ *
+ * Thread-safe with respect to other pushes and reads.
+ *
+ * Complexity: O(1), plus one segment allocation when the push is the first
+ * one to reach a segment
+ *
+ * Terminates the program if a new segment can not be allocated.
+ *
+ * @returns index of the element
+ */
+size_t cvector_push(cvector* cv, void const* item);
+
+/** Append n contiguous elements
+ *
+ * Reserves all slots with a single fetch-add, so the elements get
+ * consecutive indices even if other threads push at the same time.
+ * Terminates the program if a new segment can not be allocated.
+ *
+ * @returns index of the first element
+ */
+size_t cvector_push_n(cvector* cv, void const* items, size_t n);
+
+/** Get an element at index
+ *
+ * Terminates the program if index >= size. See `cvector` for when an element
+ * written by another thread may be read.
+ *
+ * Complexity: O(1)
+ */
+void* cvector_at(cvector* cv, size_t index);
+
+/** Convert to a contiguous vector
+ *
+ * Copies all elements into a new `vector` and destroys the concurrent
+ * vector. Must not run concurrently with any other operation.
+ *
+ * Returns NULL if memory can not be allocated; the concurrent vector is
+ * left intact then.
+ *
+ * Complexity: O(n)
+ */
+vector* cvector_freeze(cvector* cv);
+
+#endif
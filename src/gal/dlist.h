@@ -23,7 +23,7 @@
  * @field data
  * User data
  */
-typedef struct {
+typedef struct dlist {
   struct dlist* head;
   struct dlist* tail;
   struct dlist* left;
@@ -31,6 +31,62 @@ typedef struct {
   void* data;
 } dlist;
 
+/** Position in a list
+ *
+ * Walks the nodes through their `left` and `right` links, so a full
+ * traversal is O(n) instead of O(n^2) with `dlist_at`. A cursor whose node
+ * is removed must not be used again.
+ *
+ * @field _node
+ * Current node, or NULL past either end
+ */
+typedef struct {
+  dlist* _node;
+} dlist_cursor;
+
+/** Get a cursor at the head of a list */
+static inline dlist_cursor dlist_cursor_front(dlist* lst) {
+  dlist_cursor c = {lst->head};
+  return c;
+}
+
+/** Get a cursor at the tail of a list */
+static inline dlist_cursor dlist_cursor_back(dlist* lst) {
+  dlist_cursor c = {lst->tail};
+  return c;
+}
+
+/** Check whether a cursor points at a node */
+static inline int dlist_cursor_valid(dlist_cursor c) { return c._node != NULL; }
+
+/** Move a cursor to the right */
+static inline void dlist_cursor_next(dlist_cursor* c) {
+  c->_node = c->_node->right;
+}
+
+/** Move a cursor to the left */
+static inline void dlist_cursor_prev(dlist_cursor* c) {
+  c->_node = c->_node->left;
+}
+
+/** Get the node under a cursor */
+static inline dlist* dlist_cursor_node(dlist_cursor c) { return c._node; }
+
+/** Get the user data of the node under a cursor */
+static inline void* dlist_cursor_get(dlist_cursor c) { return c._node->data; }
+
+/** Iterate over the nodes of a list from head to tail
+ *
+ * Declares `node` as a `dlist*`. The current node must not be removed inside
+ * the loop.
+ */
+#define DLIST_FOREACH(node, lst)                                               \
+  for (dlist* node = (lst)->head; node; node = node->right)
+
+/** Iterate over the nodes of a list from tail to head */
+#define DLIST_FOREACH_REVERSE(node, lst)                                       \
+  for (dlist* node = (lst)->tail; node; node = node->left)
+
 /** Create a list */
 dlist* dlist_init(void);
 
@@ -0,0 +1,194 @@
+#include "ebr.h"
+#include "platform.h"
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/** Number of epochs a retired node can be in before it is safe to free */
+#define GAL_EBR_EPOCHS 3
+
+typedef struct {
+  void* ptr;
+  size_t size;
+} gal_ebr_node;
+
+/* Nodes retired by one thread during one epoch */
+typedef struct {
+  gal_ebr_node* nodes;
+  size_t size;
+  size_t capacity;
+  size_t epoch;
+} gal_ebr_limbo;
+
+struct gal_ebr {
+  _Alignas(GAL_CACHE_LINE_SIZE) atomic_size_t epoch;
+  _Alignas(GAL_CACHE_LINE_SIZE) gal_ebr_thread* _Atomic threads;
+  gal_allocator allocator;
+};
+
+/* `state` holds the epoch observed on entry shifted left by one, with the
+ * lowest bit set while the thread is inside a critical section. */
+struct gal_ebr_thread {
+  _Alignas(GAL_CACHE_LINE_SIZE) atomic_size_t state;
+  atomic_int in_use;
+  gal_ebr_thread* next;
+  gal_ebr* ebr;
+  gal_ebr_limbo limbo[GAL_EBR_EPOCHS];
+  size_t since_collect;
+};
+
+gal_ebr* gal_ebr_init(gal_allocator allocator) {
+  gal_ebr* ebr = aligned_alloc(_Alignof(gal_ebr), sizeof(gal_ebr));
+  if (!ebr)
+    return NULL;
+
+  atomic_init(&ebr->epoch, 0);
+  atomic_init(&ebr->threads, NULL);
+  ebr->allocator = allocator ? allocator : gal_std_allocator;
+
+  return ebr;
+}
+
+static void gal_ebr_free_limbo(gal_ebr* ebr, gal_ebr_limbo* limbo) {
+  for (size_t i = 0; i < limbo->size; ++i) {
+    ebr->allocator(limbo->nodes[i].ptr, limbo->nodes[i].size, 0);
+  }
+  limbo->size = 0;
+}
+
+void gal_ebr_deinit(gal_ebr* ebr) {
+  gal_ebr_thread* t = atomic_load(&ebr->threads);
+  while (t) {
+    gal_ebr_thread* next = t->next;
+    for (size_t i = 0; i < GAL_EBR_EPOCHS; ++i) {
+      gal_ebr_free_limbo(ebr, &t->limbo[i]);
+      ebr->allocator(t->limbo[i].nodes,
+                     t->limbo[i].capacity * sizeof(gal_ebr_node), 0);
+    }
+    free(t);
+    t = next;
+  }
+
+  free(ebr);
+}
+
+gal_ebr_thread* gal_ebr_register(gal_ebr* ebr) {
+  for (gal_ebr_thread* t = atomic_load(&ebr->threads); t; t = t->next) {
+    int expected = 0;
+    if (atomic_compare_exchange_strong(&t->in_use, &expected, 1))
+      return t;
+  }
+
+  gal_ebr_thread* t =
+      aligned_alloc(_Alignof(gal_ebr_thread), sizeof(gal_ebr_thread));
+  if (!t)
+    return NULL;
+
+  atomic_init(&t->state, 0);
+  atomic_init(&t->in_use, 1);
+  t->ebr = ebr;
+  t->since_collect = 0;
+  for (size_t i = 0; i < GAL_EBR_EPOCHS; ++i) {
+    t->limbo[i].nodes = NULL;
+    t->limbo[i].size = 0;
+    t->limbo[i].capacity = 0;
+    t->limbo[i].epoch = 0;
+  }
+
+  t->next = atomic_load(&ebr->threads);
+  while (!atomic_compare_exchange_weak(&ebr->threads, &t->next, t)) {
+  }
+
+  return t;
+}
+
+void gal_ebr_unregister(gal_ebr_thread* t) {
+  assert(!(atomic_load(&t->state) & 1) && "gal_ebr_unregister");
+  atomic_store_explicit(&t->in_use, 0, memory_order_release);
+}
+
+void gal_ebr_enter(gal_ebr_thread* t) {
+  assert(!(atomic_load_explicit(&t->state, memory_order_relaxed) & 1) &&
+         "gal_ebr_enter");
+
+  size_t epoch = atomic_load_explicit(&t->ebr->epoch, memory_order_relaxed);
+  atomic_store_explicit(&t->state, epoch << 1 | 1, memory_order_relaxed);
+  /* The announcement must be visible before any shared pointer is read */
+  atomic_thread_fence(memory_order_seq_cst);
+}
+
+void gal_ebr_exit(gal_ebr_thread* t) {
+  size_t state = atomic_load_explicit(&t->state, memory_order_relaxed);
+  atomic_store_explicit(&t->state, state & ~(size_t)1, memory_order_release);
+}
+
+/* Advances the global epoch if every thread inside a critical section has
+ * observed the current one. */
+static void gal_ebr_try_advance(gal_ebr* ebr) {
+  size_t epoch = atomic_load(&ebr->epoch);
+
+  for (gal_ebr_thread* t = atomic_load(&ebr->threads); t; t = t->next) {
+    size_t state = atomic_load(&t->state);
+    if ((state & 1) && (state >> 1) != epoch)
+      return;
+  }
+
+  atomic_compare_exchange_strong(&ebr->epoch, &epoch, epoch + 1);
+}
+
+void gal_ebr_collect(gal_ebr_thread* t) {
+  gal_ebr* ebr = t->ebr;
+  t->since_collect = 0;
+
+  gal_ebr_try_advance(ebr);
+
+  size_t epoch = atomic_load(&ebr->epoch);
+  for (size_t i = 0; i < GAL_EBR_EPOCHS; ++i) {
+    gal_ebr_limbo* limbo = &t->limbo[i];
+    if (limbo->size > 0 && limbo->epoch + 2 <= epoch)
+      gal_ebr_free_limbo(ebr, limbo);
+  }
+}
+
+void gal_ebr_retire(gal_ebr_thread* t, void* ptr, size_t size) {
+  gal_ebr* ebr = t->ebr;
+  size_t epoch = atomic_load(&ebr->epoch);
+  gal_ebr_limbo* limbo = &t->limbo[epoch % GAL_EBR_EPOCHS];
+
+  /* A non-empty list in this slot is at least GAL_EBR_EPOCHS epochs old */
+  if (limbo->epoch != epoch) {
+    gal_ebr_free_limbo(ebr, limbo);
+    limbo->epoch = epoch;
+  }
+
+  if (limbo->size == limbo->capacity) {
+    size_t capacity = limbo->capacity ? limbo->capacity * 2 : GAL_EBR_BATCH;
+    gal_ebr_node* nodes =
+        ebr->allocator(limbo->nodes, limbo->capacity * sizeof(gal_ebr_node),
+                       capacity * sizeof(gal_ebr_node));
+    /* Readers may still hold the node, so it can neither be freed now nor
+     * be dropped */
+    if (!nodes) {
+      fprintf(stderr, "gal_ebr_retire: out of memory\n");
+      abort();
+    }
+    limbo->nodes = nodes;
+    limbo->capacity = capacity;
+  }
+
+  limbo->nodes[limbo->size].ptr = ptr;
+  limbo->nodes[limbo->size].size = size;
+  limbo->size += 1;
+
+  if (++t->since_collect >= GAL_EBR_BATCH)
+    gal_ebr_collect(t);
+}
+
+size_t gal_ebr_pending(gal_ebr_thread* t) {
+  size_t pending = 0;
+  for (size_t i = 0; i < GAL_EBR_EPOCHS; ++i) {
+    pending += t->limbo[i].size;
+  }
+  return pending;
+}
@@ -0,0 +1,97 @@
+/** ebr.h - epoch-based memory reclamation for lock-free structures */
+
+#ifndef GAL_EBR_H
+#define GAL_EBR_H
+
+#include <stddef.h>
+
+#include "allocator.h"
+
+/** Number of retirements after which a thread tries to reclaim memory */
+#ifndef GAL_EBR_BATCH
+#define GAL_EBR_BATCH 64
+#endif
+
+/** Reclamation domain
+ *
+ * Threads that read a shared structure register with its domain and wrap
+ * every access in `gal_ebr_enter`/`gal_ebr_exit`. A node unlinked from the
+ * structure is passed to `gal_ebr_retire` instead of being freed. It is
+ * returned to the allocator once every thread has left the critical section
+ * it was in when the node was retired, which the domain detects by advancing
+ * a global epoch counter.
+ *
+ * Retired nodes are kept in per-thread lists, one per recent epoch, and are
+ * freed in batches: every GAL_EBR_BATCH retirements a thread tries to advance
+ * the epoch and releases the lists that became safe.
+ */
+typedef struct gal_ebr gal_ebr;
+
+/** Per-thread state of a reclamation domain */
+typedef struct gal_ebr_thread gal_ebr_thread;
+
+/** Create a reclamation domain
+ *
+ * Retired memory is returned through `allocator`; if it is NULL,
+ * `gal_std_allocator` is used.
+ *
+ * Returns NULL if memory can not be allocated.
+ */
+gal_ebr* gal_ebr_init(gal_allocator allocator);
+
+/** Destroy a reclamation domain
+ *
+ * Frees all memory that is still waiting for reclamation. No thread may be
+ * inside a critical section.
+ */
+void gal_ebr_deinit(gal_ebr* ebr);
+
+/** Register the calling thread
+ *
+ * Reuses the state of a thread that has unregistered, if there is one.
+ *
+ * Returns NULL if memory can not be allocated.
+ */
+gal_ebr_thread* gal_ebr_register(gal_ebr* ebr);
+
+/** Unregister a thread
+ *
+ * Memory retired by the thread and not yet reclaimed stays with its state
+ * and is released by the next thread that takes the state over, or by
+ * `gal_ebr_deinit`.
+ */
+void gal_ebr_unregister(gal_ebr_thread* t);
+
+/** Enter a critical section
+ *
+ * Pointers loaded from the shared structure stay valid until the matching
+ * `gal_ebr_exit`. Critical sections must not nest.
+ */
+void gal_ebr_enter(gal_ebr_thread* t);
+
+/** Leave a critical section */
+void gal_ebr_exit(gal_ebr_thread* t);
+
+/** Defer freeing of a node
+ *
+ * The node must already be unreachable for threads that enter a critical
+ * section from now on. It is released with `allocator(ptr, size, 0)` once no
+ * thread can hold a reference to it. Terminates the program if the list of
+ * retired nodes can not grow.
+ *
+ * Complexity: O(1) amortized
+ */
+void gal_ebr_retire(gal_ebr_thread* t, void* ptr, size_t size);
+
+/** Try to advance the epoch and free the nodes that became safe
+ *
+ * Called automatically every GAL_EBR_BATCH retirements.
+ *
+ * Complexity: O(number of registered threads + number of freed nodes)
+ */
+void gal_ebr_collect(gal_ebr_thread* t);
+
+/** Get the number of nodes retired by a thread and not yet freed */
+size_t gal_ebr_pending(gal_ebr_thread* t);
+
+#endif
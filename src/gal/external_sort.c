@@ -0,0 +1,455 @@
+#include "external_sort.h"
+#include "vector.h"
+#include <assert.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef struct {
+  int fd;
+  size_t size;
+} external_run;
+
+struct external_sort {
+  size_t element_size;
+  size_t memory_budget;
+  int (*cmp)(void const*, void const*);
+  char const* tmpdir;
+
+  vector* buffer;
+  size_t buffer_limit;
+
+  external_run* runs;
+  size_t nruns;
+  size_t runs_capacity;
+};
+
+/* Cursor over a run during a merge */
+typedef struct {
+  external_run run;
+  char* block;
+  size_t block_elements;
+  size_t loaded;
+  size_t position;
+  size_t remaining;
+} external_reader;
+
+/* Destination of a merge: either a callback or a buffered descriptor */
+typedef struct {
+  void (*emit)(void const*, void*);
+  void* ctx;
+  int fd;
+  char* block;
+  size_t block_size;
+  size_t used;
+} external_sink;
+
+static int external_write_full(int fd, void const* buf, size_t length) {
+  char const* p = buf;
+  while (length > 0) {
+    ssize_t n = write(fd, p, length);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n < 0)
+      return -1;
+    p += n;
+    length -= (size_t)n;
+  }
+  return 0;
+}
+
+static int external_read_full(int fd, void* buf, size_t length) {
+  char* p = buf;
+  while (length > 0) {
+    ssize_t n = read(fd, p, length);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n < 0)
+      return -1;
+    if (n == 0) {
+      errno = EIO;
+      return -1;
+    }
+    p += n;
+    length -= (size_t)n;
+  }
+  return 0;
+}
+
+static int external_temp_file(external_sort* s) {
+  char const* dir = s->tmpdir;
+  if (!dir)
+    dir = getenv("TMPDIR");
+  if (!dir || !*dir)
+    dir = "/tmp";
+
+  char path[PATH_MAX];
+  int len = snprintf(path, sizeof(path), "%s/gal_sort_XXXXXX", dir);
+  if (len < 0 || (size_t)len >= sizeof(path)) {
+    errno = ENAMETOOLONG;
+    return -1;
+  }
+
+  int fd = mkstemp(path);
+  if (fd >= 0)
+    unlink(path);
+  return fd;
+}
+
+static int external_add_run(external_sort* s, external_run run) {
+  if (s->nruns == s->runs_capacity) {
+    size_t capacity = s->runs_capacity ? s->runs_capacity * 2 : 16;
+    external_run* runs = realloc(s->runs, capacity * sizeof(external_run));
+    if (!runs)
+      return -1;
+    s->runs = runs;
+    s->runs_capacity = capacity;
+  }
+  s->runs[s->nruns++] = run;
+  return 0;
+}
+
+/* Sorts the buffer and writes it to a new run */
+static int external_spill(external_sort* s) {
+  size_t size = vector_size(s->buffer);
+  if (size == 0)
+    return 0;
+
+  vector_quicksort(s->buffer, s->cmp);
+
+  external_run run = {external_temp_file(s), size};
+  if (run.fd < 0)
+    return -1;
+
+  if (external_write_full(run.fd, vector_data(s->buffer),
+                          size * s->element_size) != 0 ||
+      external_add_run(s, run) != 0) {
+    int saved = errno;
+    close(run.fd);
+    errno = saved;
+    return -1;
+  }
+
+  vector_clear(s->buffer);
+  return 0;
+}
+
+external_sort* external_sort_init(size_t element_size, size_t memory_budget,
+                                  int (*cmp)(void const*, void const*),
+                                  char const* tmpdir) {
+  assert(element_size > 0 && "external_sort_init");
+
+  external_sort* s = malloc(sizeof(external_sort));
+  if (!s)
+    return NULL;
+
+  s->element_size = element_size;
+  s->memory_budget = memory_budget;
+  s->cmp = cmp;
+  s->tmpdir = tmpdir;
+  s->buffer_limit = memory_budget / element_size;
+  if (s->buffer_limit < 2)
+    s->buffer_limit = 2;
+  s->runs = NULL;
+  s->nruns = 0;
+  s->runs_capacity = 0;
+
+  s->buffer = vector_init(element_size);
+  if (!s->buffer || vector_try_resize(s->buffer, s->buffer_limit) != 0) {
+    if (s->buffer)
+      vector_deinit(s->buffer);
+    free(s);
+    errno = ENOMEM;
+    return NULL;
+  }
+
+  return s;
+}
+
+void external_sort_deinit(external_sort* s) {
+  for (size_t i = 0; i < s->nruns; ++i) {
+    close(s->runs[i].fd);
+  }
+  free(s->runs);
+  if (s->buffer)
+    vector_deinit(s->buffer);
+  free(s);
+}
+
+int external_sort_push(external_sort* s, void const* item) {
+  if (vector_size(s->buffer) == s->buffer_limit && external_spill(s) != 0)
+    return -1;
+
+  vector_push(s->buffer, item);
+  return 0;
+}
+
+int external_sort_push_n(external_sort* s, void const* items, size_t n) {
+  char const* src = items;
+  size_t element_size = s->element_size;
+
+  while (n > 0) {
+    size_t size = vector_size(s->buffer);
+    if (size == s->buffer_limit) {
+      if (external_spill(s) != 0)
+        return -1;
+      size = 0;
+    }
+
+    size_t chunk = s->buffer_limit - size;
+    if (chunk > n)
+      chunk = n;
+
+    vector_push_n(s->buffer, src, chunk);
+    src += chunk * element_size;
+    n -= chunk;
+  }
+
+  return 0;
+}
+
+static int external_sink_put(external_sink* sink, void const* item,
+                             size_t element_size) {
+  if (sink->emit) {
+    sink->emit(item, sink->ctx);
+    return 0;
+  }
+
+  if (sink->used + element_size > sink->block_size) {
+    if (external_write_full(sink->fd, sink->block, sink->used) != 0)
+      return -1;
+    sink->used = 0;
+  }
+  memcpy(sink->block + sink->used, item, element_size);
+  sink->used += element_size;
+  return 0;
+}
+
+static int external_sink_flush(external_sink* sink) {
+  if (sink->emit || sink->used == 0)
+    return 0;
+  int rc = external_write_full(sink->fd, sink->block, sink->used);
+  sink->used = 0;
+  return rc;
+}
+
+static int external_reader_fill(external_reader* r, size_t element_size) {
+  size_t count = r->block_elements;
+  if (count > r->remaining)
+    count = r->remaining;
+
+  if (external_read_full(r->run.fd, r->block, count * element_size) != 0)
+    return -1;
+  r->loaded = count;
+  r->position = 0;
+  return 0;
+}
+
+static void const* external_reader_head(external_reader const* r,
+                                        size_t element_size) {
+  return r->block + r->position * element_size;
+}
+
+/* Orders readers by their current element, then by run order */
+static int external_reader_less(external_sort* s, external_reader* readers,
+                                size_t a, size_t b) {
+  int c = s->cmp(external_reader_head(&readers[a], s->element_size),
+                 external_reader_head(&readers[b], s->element_size));
+  return c < 0 || (c == 0 && a < b);
+}
+
+static void external_sift_down(external_sort* s, external_reader* readers,
+                               size_t* heap, size_t size, size_t i) {
+  for (;;) {
+    size_t smallest = i;
+    size_t left = 2 * i + 1;
+    size_t right = left + 1;
+    if (left < size &&
+        external_reader_less(s, readers, heap[left], heap[smallest]))
+      smallest = left;
+    if (right < size &&
+        external_reader_less(s, readers, heap[right], heap[smallest]))
+      smallest = right;
+    if (smallest == i)
+      return;
+
+    size_t tmp = heap[i];
+    heap[i] = heap[smallest];
+    heap[smallest] = tmp;
+    i = smallest;
+  }
+}
+
+/* Merges k runs into the sink, giving every run and the sink an equal share
+ * of the memory budget. The runs are closed. */
+static int external_merge(external_sort* s, external_run* runs, size_t k,
+                          external_sink* sink) {
+  size_t element_size = s->element_size;
+  size_t share = s->memory_budget / (k + 1);
+  size_t block_elements = share / element_size;
+  if (block_elements == 0)
+    block_elements = 1;
+
+  external_reader* readers = calloc(k, sizeof(external_reader));
+  size_t* heap = malloc(k * sizeof(size_t));
+  char* blocks = malloc(k * block_elements * element_size);
+  char* out = NULL;
+  if (!sink->emit) {
+    sink->block_size = block_elements * element_size;
+    sink->used = 0;
+    out = malloc(sink->block_size);
+    sink->block = out;
+  }
+
+  int rc = -1;
+  if (!readers || !heap || !blocks || (!sink->emit && !out)) {
+    errno = ENOMEM;
+    goto done;
+  }
+
+  size_t heap_size = 0;
+  for (size_t i = 0; i < k; ++i) {
+    external_reader* r = &readers[i];
+    r->run = runs[i];
+    r->block = blocks + i * block_elements * element_size;
+    r->block_elements = block_elements;
+    r->remaining = runs[i].size;
+
+    if (lseek(r->run.fd, 0, SEEK_SET) < 0 ||
+        external_reader_fill(r, element_size) != 0)
+      goto done;
+    if (r->loaded > 0)
+      heap[heap_size++] = i;
+  }
+
+  for (size_t i = heap_size / 2; i-- > 0;) {
+    external_sift_down(s, readers, heap, heap_size, i);
+  }
+
+  while (heap_size > 0) {
+    external_reader* r = &readers[heap[0]];
+    if (external_sink_put(sink, external_reader_head(r, element_size),
+                          element_size) != 0)
+      goto done;
+
+    r->position += 1;
+    r->remaining -= 1;
+    if (r->position == r->loaded) {
+      if (r->remaining == 0) {
+        heap[0] = heap[--heap_size];
+      } else if (external_reader_fill(r, element_size) != 0) {
+        goto done;
+      }
+    }
+    external_sift_down(s, readers, heap, heap_size, 0);
+  }
+
+  rc = external_sink_flush(sink);
+
+done:;
+  int saved = errno;
+  for (size_t i = 0; i < k; ++i) {
+    close(runs[i].fd);
+  }
+  free(readers);
+  free(heap);
+  free(blocks);
+  free(out);
+  errno = saved;
+  return rc;
+}
+
+/* After a failed pass, moves the runs from `first` on, which are still
+ * open, behind the `merged` runs written so far; the slots in between hold
+ * descriptors that were closed by their merge */
+static void external_keep_runs(external_sort* s, size_t merged, size_t first) {
+  for (size_t i = first; i < s->nruns; ++i) {
+    s->runs[merged++] = s->runs[i];
+  }
+  s->nruns = merged;
+}
+
+/* Merges groups of runs until they fit into a single pass */
+static int external_reduce_runs(external_sort* s) {
+  /* one block of the budget is kept for the output */
+  size_t fan_in = s->memory_budget / EXTERNAL_SORT_MIN_BLOCK;
+  fan_in = fan_in > 3 ? fan_in - 1 : 2;
+
+  while (s->nruns > fan_in) {
+    size_t merged = 0;
+    for (size_t first = 0; first < s->nruns; first += fan_in) {
+      size_t k = s->nruns - first < fan_in ? s->nruns - first : fan_in;
+
+      external_run run = {external_temp_file(s), 0};
+      if (run.fd < 0) {
+        external_keep_runs(s, merged, first);
+        return -1;
+      }
+      for (size_t i = 0; i < k; ++i) {
+        run.size += s->runs[first + i].size;
+      }
+
+      external_sink sink = {NULL, NULL, run.fd, NULL, 0, 0};
+      int rc = external_merge(s, s->runs + first, k, &sink);
+      s->runs[merged++] = run;
+      if (rc != 0) {
+        external_keep_runs(s, merged, first + k);
+        return -1;
+      }
+    }
+    s->nruns = merged;
+  }
+
+  return 0;
+}
+
+static int external_finish(external_sort* s, external_sink* sink) {
+  size_t element_size = s->element_size;
+
+  if (s->nruns == 0) {
+    vector* buffer = s->buffer;
+    vector_quicksort(buffer, s->cmp);
+
+    if (!sink->emit) {
+      int rc = external_write_full(sink->fd, vector_data(buffer),
+                                   vector_size(buffer) * element_size);
+      vector_deinit(buffer);
+      s->buffer = NULL;
+      return rc;
+    }
+
+    for (size_t i = 0; i < vector_size(buffer); ++i) {
+      sink->emit(vector_at_unchecked(buffer, i), sink->ctx);
+    }
+    vector_deinit(buffer);
+    s->buffer = NULL;
+    return 0;
+  }
+
+  int rc = external_spill(s);
+  vector_deinit(s->buffer);
+  s->buffer = NULL;
+  if (rc != 0 || external_reduce_runs(s) != 0)
+    return -1;
+
+  size_t nruns = s->nruns;
+  s->nruns = 0;
+  return external_merge(s, s->runs, nruns, sink);
+}
+
+int external_sort_finish(external_sort* s,
+                         void (*emit)(void const* item, void* ctx),
+                         void* ctx) {
+  assert(s->buffer && "external_sort_finish");
+  external_sink sink = {emit, ctx, -1, NULL, 0, 0};
+  return external_finish(s, &sink);
+}
+
+int external_sort_finish_fd(external_sort* s, int fd) {
+  assert(s->buffer && "external_sort_finish_fd");
+  external_sink sink = {NULL, NULL, fd, NULL, 0, 0};
+  return external_finish(s, &sink);
+}
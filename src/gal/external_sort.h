@@ -0,0 +1,87 @@
+/** external_sort.h - merge sort for data sets larger than memory */
+
+#ifndef GAL_EXTERNAL_SORT_H
+#define GAL_EXTERNAL_SORT_H
+
+#include <stddef.h>
+
+/** Smallest I/O block used for a run during a merge
+ *
+ * When the memory budget can not give every run a block of at least this
+ * size, runs are merged in several passes.
+ */
+#ifndef EXTERNAL_SORT_MIN_BLOCK
+#define EXTERNAL_SORT_MIN_BLOCK (64 * 1024)
+#endif
+
+/** External merge sort
+ *
+ * Accepts a stream of fixed-size elements. Elements are collected in a
+ * memory buffer of the configured budget; whenever it fills up, the buffer
+ * is sorted with `vector_quicksort` and spilled to an unlinked temporary file
+ * as a sorted run. Finishing the sort merges the runs with a binary heap,
+ * reading every run and writing the output in large sequential blocks that
+ * share the same budget. If all elements fit into the budget, nothing is
+ * written to disk.
+ *
+ * The comparison function has the same contract as for `vector_quicksort`.
+ * Equal elements are not guaranteed to keep their input order.
+ */
+typedef struct external_sort external_sort;
+
+/** Create an external sort
+ *
+ * @param element_size size of an element
+ * @param memory_budget bytes of memory to use for buffers
+ * @param cmp comparison function
+ * @param tmpdir directory for temporary files; if NULL, TMPDIR or /tmp is
+ * used
+ * @returns sort or NULL if memory can not be allocated
+ */
+external_sort* external_sort_init(size_t element_size, size_t memory_budget,
+                                  int (*cmp)(void const*, void const*),
+                                  char const* tmpdir);
+
+/** Destroy an external sort
+ *
+ * Closes remaining temporary files.
+ */
+void external_sort_deinit(external_sort* s);
+
+/** Add an element
+ *
+ * Returns 0 on success and -1 with errno set if a run can not be spilled.
+ *
+ * Complexity: O(1) amortized, plus sorting and writing a run when the buffer
+ * is full
+ */
+int external_sort_push(external_sort* s, void const* item);
+
+/** Add n contiguous elements
+ *
+ * Returns 0 on success and -1 with errno set if a run can not be spilled.
+ */
+int external_sort_push_n(external_sort* s, void const* items, size_t n);
+
+/** Merge all elements and pass them to a callback in sorted order
+ *
+ * The pointer passed to `emit` is valid only during the call. After this
+ * function returns, the sort can only be destroyed.
+ *
+ * Returns 0 on success and -1 with errno set on I/O failure.
+ */
+int external_sort_finish(external_sort* s,
+                         void (*emit)(void const* item, void* ctx),
+                         void* ctx);
+
+/** Merge all elements and write them to a file descriptor in sorted order
+ *
+ * Elements are written as a raw block, without a header, starting at the
+ * current offset. After this function returns, the sort can only be
+ * destroyed.
+ *
+ * Returns 0 on success and -1 with errno set on I/O failure.
+ */
+int external_sort_finish_fd(external_sort* s, int fd);
+
+#endif
@@ -0,0 +1,3 @@
+/* Whole library as one translation unit, see GAL_AMALGAMATE */
+#define GAL_IMPLEMENTATION
+#include "gal.h"
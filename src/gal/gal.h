@@ -0,0 +1,71 @@
+/** gal.h - every gal container in one header
+ *
+ * Define GAL_IMPLEMENTATION in one translation unit before including this
+ * header to compile the whole library into that unit. The compiler then
+ * sees the bodies of `vector_at`, `vector_push` and the rest next to the
+ * calling code and can inline them without link-time optimization. Include
+ * the header first in that unit, since the implementation needs feature
+ * macros set before any system header. Define GAL_THREADS as well to get
+ * the thread pool and the sharded LRU cache.
+ *
+ * Every other unit includes this header without GAL_IMPLEMENTATION.
+ */
+
+#ifndef GAL_H
+#define GAL_H
+
+#ifdef GAL_IMPLEMENTATION
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#endif
+
+#include "allocator.h"
+#include "bitset.h"
+#include "columnar.h"
+#include "cow_vector.h"
+#include "cskiplist.h"
+#include "cvector.h"
+#include "ebr.h"
+#include "external_sort.h"
+#include "intseq.h"
+#include "lru_cache.h"
+#include "platform.h"
+#include "skiplist.h"
+#include "spsc_ring.h"
+#include "vector.h"
+#include "vector_io.h"
+#include "vector_mmap.h"
+#include "vector_set.h"
+#ifdef GAL_THREADS
+#include "clru_cache.h"
+#include "thread_pool.h"
+#endif
+
+#endif
+
+#if defined(GAL_IMPLEMENTATION) && !defined(GAL_IMPLEMENTATION_INCLUDED)
+#define GAL_IMPLEMENTATION_INCLUDED
+
+#include "allocator.c"
+#include "bitset.c"
+#include "columnar.c"
+#include "cow_vector.c"
+#include "cskiplist.c"
+#include "cvector.c"
+#include "ebr.c"
+#include "external_sort.c"
+#include "intseq.c"
+#include "lru_cache.c"
+#include "skiplist.c"
+#include "spsc_ring.c"
+#include "vector.c"
+#include "vector_io.c"
+#include "vector_mmap.c"
+#include "vector_set.c"
+#ifdef GAL_THREADS
+#include "clru_cache.c"
+#include "thread_pool.c"
+#endif
+
+#endif
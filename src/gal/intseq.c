@@ -0,0 +1,284 @@
+#include "intseq.h"
+#include <assert.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Bytes after the payload so that every read can load 9 bytes */
+#define INTSEQ_PADDING 9
+
+struct intseq {
+  size_t size;
+  size_t nblocks;
+  size_t payload_size;
+  /* skip index, one entry per block */
+  uint64_t* firsts;
+  size_t* offsets;
+  uint8_t* widths;
+  uint8_t* payload;
+};
+
+static uint64_t intseq_load64(uint8_t const* p) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  uint64_t x;
+  memcpy(&x, p, sizeof(x));
+  return x;
+#else
+  uint64_t x = 0;
+  for (size_t i = 0; i < 8; ++i) {
+    x |= (uint64_t)p[i] << (8 * i);
+  }
+  return x;
+#endif
+}
+
+static void intseq_store64(uint8_t* p, uint64_t x) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  memcpy(p, &x, sizeof(x));
+#else
+  for (size_t i = 0; i < 8; ++i) {
+    p[i] = (uint8_t)(x >> (8 * i));
+  }
+#endif
+}
+
+static uint64_t intseq_mask(unsigned width) {
+  return width == 64 ? ~UINT64_C(0) : (UINT64_C(1) << width) - 1;
+}
+
+/* Reads a `width`-bit field with one unaligned load; fields that end past
+ * the loaded word take their top bits from the ninth byte */
+static uint64_t intseq_read(uint8_t const* data, uint64_t bit, unsigned width,
+                            uint64_t mask) {
+  size_t byte = bit >> 3;
+  unsigned shift = bit & 7;
+  uint64_t x = intseq_load64(data + byte) >> shift;
+  if (shift + width > 64)
+    x |= (uint64_t)data[byte + 8] << (64 - shift);
+  return x & mask;
+}
+
+/* Fields of at most INTSEQ_SHORT_WIDTH bits always fit in the loaded word,
+ * so the common widths decode without a branch per value */
+#define INTSEQ_SHORT_WIDTH 57
+
+static uint64_t intseq_read_short(uint8_t const* data, uint64_t bit,
+                                  uint64_t mask) {
+  return (intseq_load64(data + (bit >> 3)) >> (bit & 7)) & mask;
+}
+
+static void intseq_write(uint8_t* data, uint64_t bit, unsigned width,
+                         uint64_t value) {
+  size_t byte = bit >> 3;
+  unsigned shift = bit & 7;
+  intseq_store64(data + byte, intseq_load64(data + byte) | value << shift);
+  if (shift + width > 64)
+    data[byte + 8] |= (uint8_t)(value >> (64 - shift));
+}
+
+static size_t intseq_block_count(intseq const* seq, size_t block) {
+  size_t begin = block * INTSEQ_BLOCK_SIZE;
+  return seq->size - begin < INTSEQ_BLOCK_SIZE ? seq->size - begin
+                                               : INTSEQ_BLOCK_SIZE;
+}
+
+intseq* intseq_init(uint64_t const* values, size_t n) {
+  intseq* seq = calloc(1, sizeof(intseq));
+  if (!seq)
+    return NULL;
+
+  seq->size = n;
+  seq->nblocks = (n + INTSEQ_BLOCK_SIZE - 1) / INTSEQ_BLOCK_SIZE;
+  size_t nblocks = seq->nblocks ? seq->nblocks : 1;
+  seq->firsts = malloc(nblocks * sizeof(uint64_t));
+  seq->offsets = malloc(nblocks * sizeof(size_t));
+  seq->widths = malloc(nblocks);
+  if (!seq->firsts || !seq->offsets || !seq->widths)
+    goto fail;
+
+  /* First pass sizes the payload, second one packs it */
+  size_t payload_size = 0;
+  for (size_t b = 0; b < seq->nblocks; ++b) {
+    uint64_t const* block = values + b * INTSEQ_BLOCK_SIZE;
+    size_t count = intseq_block_count(seq, b);
+
+    uint64_t max_delta = 0;
+    for (size_t i = 1; i < count; ++i) {
+      assert(block[i - 1] <= block[i] && "intseq_init");
+      uint64_t delta = block[i] - block[i - 1];
+      if (delta > max_delta)
+        max_delta = delta;
+    }
+
+    unsigned width = max_delta ? 64 - __builtin_clzll(max_delta) : 0;
+    seq->firsts[b] = block[0];
+    seq->offsets[b] = payload_size;
+    seq->widths[b] = (uint8_t)width;
+    payload_size += ((count - 1) * width + 7) / 8;
+  }
+
+  seq->payload_size = payload_size;
+  seq->payload = calloc(payload_size + INTSEQ_PADDING, 1);
+  if (!seq->payload)
+    goto fail;
+
+  for (size_t b = 0; b < seq->nblocks; ++b) {
+    uint64_t const* block = values + b * INTSEQ_BLOCK_SIZE;
+    size_t count = intseq_block_count(seq, b);
+    unsigned width = seq->widths[b];
+    uint8_t* data = seq->payload + seq->offsets[b];
+    for (size_t i = 1; i < count && width > 0; ++i) {
+      intseq_write(data, (uint64_t)(i - 1) * width, width,
+                   block[i] - block[i - 1]);
+    }
+  }
+
+  return seq;
+
+fail:
+  intseq_deinit(seq);
+  errno = ENOMEM;
+  return NULL;
+}
+
+intseq* intseq_from_vector(vector* v) {
+  assert(vector_element_size(v) == sizeof(uint64_t) && "intseq_from_vector");
+  return intseq_init(vector_data(v), vector_size(v));
+}
+
+void intseq_deinit(intseq* seq) {
+  free(seq->payload);
+  free(seq->widths);
+  free(seq->offsets);
+  free(seq->firsts);
+  free(seq);
+}
+
+size_t intseq_size(intseq const* seq) { return seq->size; }
+
+size_t intseq_memory_usage(intseq const* seq) {
+  return sizeof(intseq) +
+         seq->nblocks * (sizeof(uint64_t) + sizeof(size_t) + 1) +
+         seq->payload_size + INTSEQ_PADDING;
+}
+
+uint64_t intseq_at(intseq const* seq, size_t index) {
+  assert(index < seq->size && "intseq_at");
+
+  size_t b = index / INTSEQ_BLOCK_SIZE;
+  size_t n = index % INTSEQ_BLOCK_SIZE;
+  unsigned width = seq->widths[b];
+  uint64_t mask = intseq_mask(width);
+  uint8_t const* data = seq->payload + seq->offsets[b];
+
+  uint64_t value = seq->firsts[b];
+  for (size_t i = 0; i < n && width > 0; ++i) {
+    value += intseq_read(data, (uint64_t)i * width, width, mask);
+  }
+  return value;
+}
+
+size_t intseq_lower_bound(intseq const* seq, uint64_t key) {
+  if (seq->nblocks == 0)
+    return 0;
+
+  /* First block that starts at or above the key; the halving step compiles
+   * to a conditional move, so random keys cause no mispredictions */
+  uint64_t const* base = seq->firsts;
+  for (size_t n = seq->nblocks; n > 1; n -= n / 2) {
+    base = base[n / 2] < key ? base + n / 2 : base;
+  }
+  size_t lo = (size_t)(base - seq->firsts) + (*base < key);
+  if (lo == 0)
+    return 0;
+
+  /* The answer is in the block before it, or is that block's first value */
+  size_t b = lo - 1;
+  size_t count = intseq_block_count(seq, b);
+  unsigned width = seq->widths[b];
+  uint64_t mask = intseq_mask(width);
+  uint8_t const* data = seq->payload + seq->offsets[b];
+
+  uint64_t value = seq->firsts[b];
+  size_t i = 1;
+  if (width == 0) {
+    i = count;
+  } else if (width <= INTSEQ_SHORT_WIDTH) {
+    /* Skip eight values per step with independent reads, then find the
+     * value within the last step */
+    uint64_t bit = 0;
+    for (; i + 8 <= count; i += 8, bit += 8 * width) {
+      uint64_t sum = 0;
+      for (size_t k = 0; k < 8; ++k) {
+        sum += intseq_read_short(data, bit + k * width, mask);
+      }
+      if (value + sum >= key)
+        break;
+      value += sum;
+    }
+    for (; i < count; ++i, bit += width) {
+      value += intseq_read_short(data, bit, mask);
+      if (value >= key)
+        break;
+    }
+  } else {
+    for (uint64_t bit = 0; i < count; ++i, bit += width) {
+      value += intseq_read(data, bit, width, mask);
+      if (value >= key)
+        break;
+    }
+  }
+  return b * INTSEQ_BLOCK_SIZE + i;
+}
+
+size_t intseq_decode_block(intseq const* seq, size_t block, uint64_t* out) {
+  assert(block < seq->nblocks && "intseq_decode_block");
+
+  size_t count = intseq_block_count(seq, block);
+  unsigned width = seq->widths[block];
+  uint64_t value = seq->firsts[block];
+  out[0] = value;
+
+  if (width == 0) {
+    for (size_t i = 1; i < count; ++i) {
+      out[i] = value;
+    }
+    return count;
+  }
+
+  uint64_t mask = intseq_mask(width);
+  uint8_t const* data = seq->payload + seq->offsets[block];
+  uint64_t bit = 0;
+  if (width <= INTSEQ_SHORT_WIDTH) {
+    for (size_t i = 1; i < count; ++i, bit += width) {
+      value += intseq_read_short(data, bit, mask);
+      out[i] = value;
+    }
+  } else {
+    for (size_t i = 1; i < count; ++i, bit += width) {
+      value += intseq_read(data, bit, width, mask);
+      out[i] = value;
+    }
+  }
+  return count;
+}
+
+void intseq_iter_init(intseq_iter* it, intseq const* seq, size_t index) {
+  it->_seq = seq;
+  it->_index = index;
+  it->_end = index;
+}
+
+int intseq_iter_next(intseq_iter* it, uint64_t* value) {
+  if (it->_index >= it->_seq->size)
+    return 0;
+
+  if (it->_index == it->_end) {
+    size_t block = it->_index / INTSEQ_BLOCK_SIZE;
+    it->_end = block * INTSEQ_BLOCK_SIZE +
+               intseq_decode_block(it->_seq, block, it->_buffer);
+  }
+  *value = it->_buffer[it->_index % INTSEQ_BLOCK_SIZE];
+  it->_index += 1;
+  return 1;
+}
@@ -0,0 +1,98 @@
+/** intseq.h - compressed sequence of sorted 64-bit integers */
+
+#ifndef GAL_INTSEQ_H
+#define GAL_INTSEQ_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "vector.h"
+
+/** Number of values in a block of a compressed sequence */
+#define INTSEQ_BLOCK_SIZE 64
+
+/** Read-only sequence of non-decreasing 64-bit integers
+ *
+ * Values are split into blocks of INTSEQ_BLOCK_SIZE. A block stores the
+ * differences between neighbouring values, bit-packed at the width of the
+ * largest one, so densely numbered ids take a few bits each instead of 64.
+ *
+ * A skip index holds the first value, the payload offset and the bit width
+ * of every block in separate arrays. Random access and `intseq_lower_bound`
+ * search the first values and decode a single block.
+ */
+typedef struct intseq intseq;
+
+/** Iterator over a compressed sequence
+ *
+ * Decodes one block at a time into its buffer.
+ *
+ * @field _index
+ * Index of the next value
+ *
+ * @field _end
+ * Index one past the last buffered value
+ */
+typedef struct {
+  intseq const* _seq;
+  size_t _index;
+  size_t _end;
+  uint64_t _buffer[INTSEQ_BLOCK_SIZE];
+} intseq_iter;
+
+/** Compress an array of non-decreasing integers
+ *
+ * @returns sequence or NULL if memory can not be allocated
+ *
+ * Complexity: O(n)
+ */
+intseq* intseq_init(uint64_t const* values, size_t n);
+
+/** Compress a vector of non-decreasing `uint64_t` elements
+ *
+ * @returns sequence or NULL if memory can not be allocated
+ *
+ * Complexity: O(n)
+ */
+intseq* intseq_from_vector(vector* v);
+
+/** Destroy a compressed sequence */
+void intseq_deinit(intseq* seq);
+
+/** Get the number of values */
+size_t intseq_size(intseq const* seq);
+
+/** Get the number of bytes the sequence occupies */
+size_t intseq_memory_usage(intseq const* seq);
+
+/** Get the value at an index
+ *
+ * Complexity: O(INTSEQ_BLOCK_SIZE)
+ */
+uint64_t intseq_at(intseq const* seq, size_t index);
+
+/** Find the index of the first value that is not less than the key
+ *
+ * Returns the size of the sequence if all values are less than the key.
+ *
+ * Complexity: O(log(n / INTSEQ_BLOCK_SIZE) + INTSEQ_BLOCK_SIZE)
+ */
+size_t intseq_lower_bound(intseq const* seq, uint64_t key);
+
+/** Decode all values of a block
+ *
+ * @param out buffer for INTSEQ_BLOCK_SIZE values
+ * @returns number of values in the block
+ */
+size_t intseq_decode_block(intseq const* seq, size_t block, uint64_t* out);
+
+/** Start iterating at an index */
+void intseq_iter_init(intseq_iter* it, intseq const* seq, size_t index);
+
+/** Get the next value
+ *
+ * Returns 1 and stores the value, or returns 0 at the end of the sequence.
+ */
+int intseq_iter_next(intseq_iter* it, uint64_t* value);
+
+#endif
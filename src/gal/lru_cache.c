@@ -0,0 +1,305 @@
+#include "lru_cache.h"
+#include <assert.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Link that ends the recency list and the free list */
+#define LRU_NIL UINT32_MAX
+
+/* Alignment of the values in the pool */
+#define LRU_ALIGN _Alignof(max_align_t)
+
+/* Header of a pool entry, followed by the key and then the value */
+typedef struct {
+  uint32_t left;  /* more recently used entry */
+  uint32_t right; /* less recently used entry, or next free entry */
+  uint32_t hash;  /* low half of the key hash */
+} lru_entry;
+
+/* Index slot: `entry` is the entry number plus one, 0 marks an empty slot.
+ * The hash lets a probe skip other keys without touching their entries. */
+typedef struct {
+  uint32_t hash;
+  uint32_t entry;
+} lru_slot;
+
+struct lru_cache {
+  size_t key_size;
+  size_t value_size;
+  size_t value_offset;
+  size_t stride;
+  size_t capacity;
+  size_t size;
+  size_t mask; /* number of index slots minus one */
+  uint32_t head;
+  uint32_t tail;
+  uint32_t free;
+  lru_stats stats;
+  unsigned char* pool;
+  lru_slot* slots;
+};
+
+static size_t lru_cache_round_up(size_t n) {
+  return (n + LRU_ALIGN - 1) / LRU_ALIGN * LRU_ALIGN;
+}
+
+static lru_entry* lru_cache_entry(lru_cache const* c, uint32_t i) {
+  return (lru_entry*)(c->pool + (size_t)i * c->stride);
+}
+
+static void* lru_cache_key(lru_cache const* c, uint32_t i) {
+  return (unsigned char*)lru_cache_entry(c, i) + sizeof(lru_entry);
+}
+
+static void* lru_cache_value(lru_cache const* c, uint32_t i) {
+  return (unsigned char*)lru_cache_entry(c, i) + c->value_offset;
+}
+
+static void lru_cache_unlink(lru_cache* c, uint32_t i) {
+  lru_entry* e = lru_cache_entry(c, i);
+  if (e->left != LRU_NIL)
+    lru_cache_entry(c, e->left)->right = e->right;
+  else
+    c->head = e->right;
+  if (e->right != LRU_NIL)
+    lru_cache_entry(c, e->right)->left = e->left;
+  else
+    c->tail = e->left;
+}
+
+static void lru_cache_push_front(lru_cache* c, uint32_t i) {
+  lru_entry* e = lru_cache_entry(c, i);
+  e->left = LRU_NIL;
+  e->right = c->head;
+  if (c->head != LRU_NIL)
+    lru_cache_entry(c, c->head)->left = i;
+  else
+    c->tail = i;
+  c->head = i;
+}
+
+static void lru_cache_touch(lru_cache* c, uint32_t i) {
+  if (c->head != i) {
+    lru_cache_unlink(c, i);
+    lru_cache_push_front(c, i);
+  }
+}
+
+/* Returns the slot holding the key, or the empty slot that ends its probe
+ * run. The index is never full, so the probe terminates. */
+static size_t lru_cache_find(lru_cache const* c, void const* key,
+                             uint32_t hash) {
+  for (size_t k = hash & c->mask;; k = (k + 1) & c->mask) {
+    lru_slot s = c->slots[k];
+    if (s.entry == 0 ||
+        (s.hash == hash &&
+         memcmp(lru_cache_key(c, s.entry - 1), key, c->key_size) == 0))
+      return k;
+  }
+}
+
+static size_t lru_cache_slot_of(lru_cache const* c, uint32_t i) {
+  size_t k = lru_cache_entry(c, i)->hash & c->mask;
+  while (c->slots[k].entry != i + 1) {
+    k = (k + 1) & c->mask;
+  }
+  return k;
+}
+
+/* Empties a slot and moves back the later slots of its probe run whose home
+ * is not between the hole and themselves, so lookups never need tombstones */
+static void lru_cache_erase_slot(lru_cache* c, size_t hole) {
+  for (size_t k = (hole + 1) & c->mask; c->slots[k].entry != 0;
+       k = (k + 1) & c->mask) {
+    size_t home = c->slots[k].hash & c->mask;
+    if (((k - home) & c->mask) >= ((k - hole) & c->mask)) {
+      c->slots[hole] = c->slots[k];
+      hole = k;
+    }
+  }
+  c->slots[hole].entry = 0;
+}
+
+/* Takes an entry out of the index and the recency list into the free list */
+static void lru_cache_release(lru_cache* c, size_t slot, uint32_t i) {
+  lru_cache_erase_slot(c, slot);
+  lru_cache_unlink(c, i);
+  lru_cache_entry(c, i)->right = c->free;
+  c->free = i;
+  c->size -= 1;
+}
+
+static void lru_cache_reset(lru_cache* c) {
+  memset(c->slots, 0, (c->mask + 1) * sizeof(lru_slot));
+  for (size_t i = 0; i < c->capacity; ++i) {
+    lru_cache_entry(c, (uint32_t)i)->right =
+        i + 1 < c->capacity ? (uint32_t)(i + 1) : LRU_NIL;
+  }
+  c->free = 0;
+  c->head = LRU_NIL;
+  c->tail = LRU_NIL;
+  c->size = 0;
+}
+
+lru_cache* lru_cache_init(size_t key_size, size_t value_size,
+                          size_t capacity) {
+  assert(key_size > 0 && capacity > 0 && "lru_cache_init");
+  assert(capacity <= LRU_CACHE_MAX_CAPACITY && "lru_cache_init");
+
+  lru_cache* c = calloc(1, sizeof(lru_cache));
+  if (!c)
+    return NULL;
+
+  c->key_size = key_size;
+  c->value_size = value_size;
+  c->value_offset = lru_cache_round_up(sizeof(lru_entry) + key_size);
+  c->stride = lru_cache_round_up(c->value_offset + value_size);
+  c->capacity = capacity;
+
+  /* At most half of the slots are in use */
+  size_t nslots = 2;
+  while (nslots < 2 * capacity) {
+    nslots *= 2;
+  }
+  c->mask = nslots - 1;
+
+  if (c->stride > SIZE_MAX / capacity ||
+      nslots > SIZE_MAX / sizeof(lru_slot))
+    goto fail;
+  c->pool = malloc(capacity * c->stride);
+  c->slots = malloc(nslots * sizeof(lru_slot));
+  if (!c->pool || !c->slots)
+    goto fail;
+
+  lru_cache_reset(c);
+  return c;
+
+fail:
+  lru_cache_deinit(c);
+  errno = ENOMEM;
+  return NULL;
+}
+
+void lru_cache_deinit(lru_cache* c) {
+  free(c->slots);
+  free(c->pool);
+  free(c);
+}
+
+size_t lru_cache_size(lru_cache const* c) { return c->size; }
+
+size_t lru_cache_capacity(lru_cache const* c) { return c->capacity; }
+
+uint64_t _lru_cache_hash(void const* key, size_t size) {
+  unsigned char const* p = key;
+  uint64_t h = 0x9e3779b97f4a7c15ull ^ size;
+  uint64_t w;
+  for (; size >= sizeof(w); p += sizeof(w), size -= sizeof(w)) {
+    memcpy(&w, p, sizeof(w));
+    h = (h ^ w) * 0xff51afd7ed558ccdull;
+    h ^= h >> 32;
+  }
+  if (size > 0) {
+    w = 0;
+    memcpy(&w, p, size);
+    h = (h ^ w) * 0xff51afd7ed558ccdull;
+  }
+
+  /* Finalizer of MurmurHash3 */
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdull;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ull;
+  h ^= h >> 33;
+  return h;
+}
+
+void* _lru_cache_get_hashed(lru_cache* c, void const* key, uint64_t hash) {
+  lru_slot s = c->slots[lru_cache_find(c, key, (uint32_t)hash)];
+  if (s.entry == 0) {
+    c->stats.misses += 1;
+    return NULL;
+  }
+
+  c->stats.hits += 1;
+  lru_cache_touch(c, s.entry - 1);
+  return lru_cache_value(c, s.entry - 1);
+}
+
+void* _lru_cache_put_hashed(lru_cache* c, void const* key, uint64_t hash,
+                            void const* value) {
+  size_t k = lru_cache_find(c, key, (uint32_t)hash);
+  uint32_t i;
+
+  if (c->slots[k].entry != 0) {
+    i = c->slots[k].entry - 1;
+    lru_cache_touch(c, i);
+  } else {
+    if (c->size == c->capacity) {
+      lru_cache_release(c, lru_cache_slot_of(c, c->tail), c->tail);
+      c->stats.evictions += 1;
+      /* Erasing may have shifted the probe run of the key */
+      k = lru_cache_find(c, key, (uint32_t)hash);
+    }
+
+    i = c->free;
+    c->free = lru_cache_entry(c, i)->right;
+    lru_cache_entry(c, i)->hash = (uint32_t)hash;
+    memcpy(lru_cache_key(c, i), key, c->key_size);
+    c->slots[k].hash = (uint32_t)hash;
+    c->slots[k].entry = i + 1;
+    lru_cache_push_front(c, i);
+    c->size += 1;
+  }
+
+  void* dst = lru_cache_value(c, i);
+  if (value)
+    memcpy(dst, value, c->value_size);
+  return dst;
+}
+
+int _lru_cache_remove_hashed(lru_cache* c, void const* key, uint64_t hash) {
+  size_t k = lru_cache_find(c, key, (uint32_t)hash);
+  if (c->slots[k].entry == 0)
+    return 0;
+
+  lru_cache_release(c, k, c->slots[k].entry - 1);
+  return 1;
+}
+
+void* lru_cache_get(lru_cache* c, void const* key) {
+  return _lru_cache_get_hashed(c, key, _lru_cache_hash(key, c->key_size));
+}
+
+void* lru_cache_peek(lru_cache* c, void const* key) {
+  uint32_t hash = (uint32_t)_lru_cache_hash(key, c->key_size);
+  lru_slot s = c->slots[lru_cache_find(c, key, hash)];
+  return s.entry ? lru_cache_value(c, s.entry - 1) : NULL;
+}
+
+void* lru_cache_put(lru_cache* c, void const* key, void const* value) {
+  return _lru_cache_put_hashed(c, key, _lru_cache_hash(key, c->key_size),
+                               value);
+}
+
+int lru_cache_remove(lru_cache* c, void const* key) {
+  return _lru_cache_remove_hashed(c, key, _lru_cache_hash(key, c->key_size));
+}
+
+int lru_cache_pop(lru_cache* c, void* key, void* value) {
+  if (c->size == 0)
+    return 0;
+
+  uint32_t i = c->tail;
+  if (key)
+    memcpy(key, lru_cache_key(c, i), c->key_size);
+  if (value)
+    memcpy(value, lru_cache_value(c, i), c->value_size);
+  lru_cache_release(c, lru_cache_slot_of(c, i), i);
+  return 1;
+}
+
+void lru_cache_clear(lru_cache* c) { lru_cache_reset(c); }
+
+lru_stats lru_cache_stats(lru_cache const* c) { return c->stats; }
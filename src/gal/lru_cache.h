@@ -0,0 +1,132 @@
+/** lru_cache.h - bounded cache with least recently used eviction */
+
+#ifndef GAL_LRU_CACHE_H
+#define GAL_LRU_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** Maximum number of entries of a cache */
+#define LRU_CACHE_MAX_CAPACITY ((size_t)UINT32_MAX / 2)
+
+/** Cache of fixed-size values under fixed-size keys
+ *
+ * Entries come from a pool allocated when the cache is created. Every entry
+ * carries `left` and `right` links of a recency list in the model of
+ * `dlist`, with the most recently used entry at the head, so an entry is
+ * moved to the front or unlinked from the tail in O(1). An open-addressing
+ * index with linear probing maps keys to entries. It is kept at most half
+ * full and removes entries by shifting the rest of their probe run back
+ * instead of leaving tombstones.
+ *
+ * Get, put and eviction take expected O(1) time and never allocate.
+ *
+ * Keys are hashed and compared byte by byte, so a key type with padding
+ * must have the padding zeroed.
+ */
+typedef struct lru_cache lru_cache;
+
+/** Counters of a cache
+ *
+ * @field hits
+ * Number of `lru_cache_get` calls that found the key
+ *
+ * @field misses
+ * Number of `lru_cache_get` calls that did not find the key
+ *
+ * @field evictions
+ * Number of entries evicted to make room for new ones
+ */
+typedef struct {
+  size_t hits;
+  size_t misses;
+  size_t evictions;
+} lru_stats;
+
+/** Create a cache
+ *
+ * @param capacity maximum number of entries, at most LRU_CACHE_MAX_CAPACITY
+ * @returns cache or NULL if memory can not be allocated
+ */
+lru_cache* lru_cache_init(size_t key_size, size_t value_size, size_t capacity);
+
+/** Destroy a cache */
+void lru_cache_deinit(lru_cache* c);
+
+/** Get the number of entries */
+size_t lru_cache_size(lru_cache const* c);
+
+/** Get the maximum number of entries */
+size_t lru_cache_capacity(lru_cache const* c);
+
+/** Look up a key and mark its entry as most recently used
+ *
+ * Counts a hit or a miss.
+ *
+ * @returns pointer to the value, or NULL if the key is not cached. The
+ * pointer is valid until the entry is removed or evicted.
+ *
+ * Complexity: O(1) expected
+ */
+void* lru_cache_get(lru_cache* c, void const* key);
+
+/** Look up a key without changing the recency order or the counters
+ *
+ * Complexity: O(1) expected
+ */
+void* lru_cache_peek(lru_cache* c, void const* key);
+
+/** Store a value under a key and mark its entry as most recently used
+ *
+ * Replaces the value if the key is cached. Otherwise evicts the least
+ * recently used entry if the cache is full.
+ *
+ * @param value value to copy, or NULL to leave the value for the caller to
+ * fill in through the returned pointer
+ * @returns pointer to the value in the cache
+ *
+ * Complexity: O(1) expected
+ */
+void* lru_cache_put(lru_cache* c, void const* key, void const* value);
+
+/** Remove the entry of a key
+ *
+ * @returns 1 if the key was cached, 0 otherwise
+ *
+ * Complexity: O(1) expected
+ */
+int lru_cache_remove(lru_cache* c, void const* key);
+
+/** Remove the least recently used entry
+ *
+ * Copies its key and value to `key` and `value` unless they are NULL. Does
+ * not count as an eviction.
+ *
+ * @returns 1 if an entry was removed, 0 if the cache is empty
+ *
+ * Complexity: O(1) expected
+ */
+int lru_cache_pop(lru_cache* c, void* key, void* value);
+
+/** Remove all entries
+ *
+ * Keeps the counters.
+ *
+ * Complexity: O(capacity)
+ */
+void lru_cache_clear(lru_cache* c);
+
+/** Get the counters */
+lru_stats lru_cache_stats(lru_cache const* c);
+
+/** Hash a key the way a cache does */
+uint64_t _lru_cache_hash(void const* key, size_t size);
+
+/** Variants of the operations above with a hash precomputed by
+ * `_lru_cache_hash`, for callers that also use it to pick a cache */
+void* _lru_cache_get_hashed(lru_cache* c, void const* key, uint64_t hash);
+void* _lru_cache_put_hashed(lru_cache* c, void const* key, uint64_t hash,
+                            void const* value);
+int _lru_cache_remove_hashed(lru_cache* c, void const* key, uint64_t hash);
+
+#endif
@@ -0,0 +1,15 @@
+/** platform.h - target-specific constants shared by gal modules */
+
+#ifndef GAL_PLATFORM_H
+#define GAL_PLATFORM_H
+
+/** Size of a destructive interference unit
+ *
+ * Fields written by different threads are kept at least this far apart to
+ * avoid false sharing.
+ */
+#ifndef GAL_CACHE_LINE_SIZE
+#define GAL_CACHE_LINE_SIZE 64
+#endif
+
+#endif
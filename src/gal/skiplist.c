@@ -0,0 +1,156 @@
+#include "skiplist.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Level 0 is the `right` link, higher levels are express lanes */
+static skiplist_node** skiplist_link(skiplist_node* node, size_t level) {
+  return level == 0 ? &node->right : &node->_lanes[level - 1];
+}
+
+static skiplist_node* skiplist_node_alloc(size_t height, size_t data_size) {
+  skiplist_node* node = malloc(skiplist_data_offset(height) + data_size);
+  if (!node)
+    return NULL;
+
+  node->left = NULL;
+  node->right = NULL;
+  node->_height = height;
+  for (size_t i = 1; i < height; ++i) {
+    node->_lanes[i - 1] = NULL;
+  }
+  return node;
+}
+
+/* Draws a height with P(h > k) = 4^-k from xorshift64 */
+static size_t skiplist_random_height(skiplist* sl) {
+  uint64_t x = sl->_random;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  sl->_random = x;
+
+  size_t height = 1;
+  while (height < SKIPLIST_MAX_LEVEL && (x & 3) == 0) {
+    height += 1;
+    x >>= 2;
+  }
+  return height;
+}
+
+/* Stores in `update` the last node before the key on every level in use and
+ * returns the first node that is not less than the key */
+static skiplist_node* skiplist_search(skiplist* sl, void const* key,
+                                      skiplist_node** update) {
+  skiplist_node* x = sl->_head;
+  for (size_t level = sl->_level; level-- > 0;) {
+    skiplist_node* next;
+    while ((next = *skiplist_link(x, level)) &&
+           sl->_cmp(skiplist_data(next), key) < 0) {
+      x = next;
+    }
+    if (update)
+      update[level] = x;
+  }
+  return x->right;
+}
+
+skiplist* skiplist_init(size_t element_size,
+                        int (*cmp)(void const*, void const*)) {
+  skiplist* sl = malloc(sizeof(skiplist));
+  if (!sl)
+    return NULL;
+
+  sl->_head = skiplist_node_alloc(SKIPLIST_MAX_LEVEL, 0);
+  if (!sl->_head) {
+    free(sl);
+    return NULL;
+  }
+
+  sl->_element_size = element_size;
+  sl->_size = 0;
+  sl->_level = 1;
+  sl->_cmp = cmp;
+  sl->_random = 0x2545f4914f6cdd1dull ^ (uintptr_t)sl;
+  sl->_tail = NULL;
+  return sl;
+}
+
+void skiplist_deinit(skiplist* sl) {
+  skiplist_node* node = sl->_head;
+  while (node) {
+    skiplist_node* next = node->right;
+    free(node);
+    node = next;
+  }
+  free(sl);
+}
+
+size_t skiplist_size(skiplist* sl) { return sl->_size; }
+
+int skiplist_insert(skiplist* sl, void const* item) {
+  skiplist_node* update[SKIPLIST_MAX_LEVEL];
+  skiplist_node* next = skiplist_search(sl, item, update);
+  if (next && sl->_cmp(skiplist_data(next), item) == 0)
+    return 0;
+
+  size_t height = skiplist_random_height(sl);
+  skiplist_node* node = skiplist_node_alloc(height, sl->_element_size);
+  if (!node) {
+    errno = ENOMEM;
+    return -1;
+  }
+  memcpy(skiplist_data(node), item, sl->_element_size);
+
+  for (; sl->_level < height; ++sl->_level) {
+    update[sl->_level] = sl->_head;
+  }
+  for (size_t level = 0; level < height; ++level) {
+    *skiplist_link(node, level) = *skiplist_link(update[level], level);
+    *skiplist_link(update[level], level) = node;
+  }
+
+  node->left = update[0] == sl->_head ? NULL : update[0];
+  if (node->right)
+    node->right->left = node;
+  else
+    sl->_tail = node;
+
+  sl->_size += 1;
+  return 1;
+}
+
+int skiplist_remove(skiplist* sl, void const* key) {
+  skiplist_node* update[SKIPLIST_MAX_LEVEL];
+  skiplist_node* node = skiplist_search(sl, key, update);
+  if (!node || sl->_cmp(skiplist_data(node), key) != 0)
+    return 0;
+
+  for (size_t level = 0; level < node->_height; ++level) {
+    *skiplist_link(update[level], level) = *skiplist_link(node, level);
+  }
+
+  if (node->right)
+    node->right->left = node->left;
+  else
+    sl->_tail = node->left;
+
+  while (sl->_level > 1 && !*skiplist_link(sl->_head, sl->_level - 1)) {
+    sl->_level -= 1;
+  }
+
+  free(node);
+  sl->_size -= 1;
+  return 1;
+}
+
+skiplist_node* skiplist_find(skiplist* sl, void const* key) {
+  skiplist_node* node = skiplist_search(sl, key, NULL);
+  if (node && sl->_cmp(skiplist_data(node), key) == 0)
+    return node;
+  return NULL;
+}
+
+skiplist_node* skiplist_lower_bound(skiplist* sl, void const* key) {
+  return skiplist_search(sl, key, NULL);
+}
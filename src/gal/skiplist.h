@@ -0,0 +1,146 @@
+/** skiplist.h - ordered set with expected logarithmic operations */
+
+#ifndef GAL_SKIPLIST_H
+#define GAL_SKIPLIST_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** Maximum number of levels of a skip list */
+#define SKIPLIST_MAX_LEVEL 32
+
+/** Node of a skip list
+ *
+ * Level 0 is a doubly linked list in the model of `dlist`, ordered by the
+ * comparison function. A node of height h also appears in the express lanes
+ * of levels 1 to h - 1. The element is stored after the lanes.
+ *
+ * @field left
+ * Previous node in order, or NULL for the first one
+ *
+ * @field right
+ * Next node in order, or NULL for the last one
+ *
+ * @field _height
+ * Number of levels the node is linked into
+ *
+ * @field _lanes
+ * Next node on levels 1 to `_height - 1`
+ */
+typedef struct skiplist_node {
+  struct skiplist_node* left;
+  struct skiplist_node* right;
+  size_t _height;
+  struct skiplist_node* _lanes[];
+} skiplist_node;
+
+/** Ordered set of fixed-size elements
+ *
+ * Every node gets a random height with a geometric distribution (p = 1/4),
+ * so search, insertion and removal take expected O(log n) steps without any
+ * rebalancing. Elements are copied into the nodes. Two elements for which
+ * the comparison function returns 0 are the same element.
+ *
+ * @field _head
+ * Sentinel that links into every level and holds no element
+ *
+ * @field _tail
+ * Last node, or NULL if the list is empty
+ *
+ * @field _level
+ * Number of levels in use
+ */
+typedef struct {
+  size_t _element_size;
+  size_t _size;
+  size_t _level;
+  int (*_cmp)(void const*, void const*);
+  uint64_t _random;
+  skiplist_node* _head;
+  skiplist_node* _tail;
+} skiplist;
+
+/** Create a skip list
+ *
+ * Comparison function must return integer value that is less than 0 if the
+ * first argument is less than the second, value greater than 0 if the first
+ * element is greater, and 0 if they are equal.
+ *
+ * Returns NULL if memory can not be allocated.
+ */
+skiplist* skiplist_init(size_t element_size,
+                        int (*cmp)(void const*, void const*));
+
+/** Destroy a skip list */
+void skiplist_deinit(skiplist* sl);
+
+/** Get the number of elements */
+size_t skiplist_size(skiplist* sl);
+
+/** Insert an element
+ *
+ * Returns 1 if the element was inserted, 0 if an equal element is already
+ * present, and -1 with errno set to ENOMEM if memory can not be allocated.
+ *
+ * Complexity: expected O(log n)
+ */
+int skiplist_insert(skiplist* sl, void const* item);
+
+/** Remove the element equal to the key
+ *
+ * Returns 1 if an element was removed and 0 if there is none.
+ *
+ * Complexity: expected O(log n)
+ */
+int skiplist_remove(skiplist* sl, void const* key);
+
+/** Find the node of the element equal to the key
+ *
+ * Returns NULL if there is none.
+ *
+ * Complexity: expected O(log n)
+ */
+skiplist_node* skiplist_find(skiplist* sl, void const* key);
+
+/** Find the node of the first element that is not less than the key
+ *
+ * Returns NULL if all elements are less than the key.
+ *
+ * Complexity: expected O(log n)
+ */
+skiplist_node* skiplist_lower_bound(skiplist* sl, void const* key);
+
+/** Offset of the element in a node of the given height */
+static inline size_t skiplist_data_offset(size_t height) {
+  size_t offset =
+      sizeof(skiplist_node) + (height - 1) * sizeof(skiplist_node*);
+  size_t align = _Alignof(max_align_t);
+  return (offset + align - 1) & ~(align - 1);
+}
+
+/** Get the element of a node */
+static inline void* skiplist_data(skiplist_node* node) {
+  return (char*)node + skiplist_data_offset(node->_height);
+}
+
+/** Get the node of the smallest element, or NULL if the list is empty */
+static inline skiplist_node* skiplist_first(skiplist* sl) {
+  return sl->_head->right;
+}
+
+/** Get the node of the largest element, or NULL if the list is empty */
+static inline skiplist_node* skiplist_last(skiplist* sl) { return sl->_tail; }
+
+/** Iterate over the nodes of a skip list in ascending order
+ *
+ * Declares `node` as a `skiplist_node*`. The current node must not be
+ * removed inside the loop.
+ */
+#define SKIPLIST_FOREACH(node, sl)                                             \
+  for (skiplist_node* node = skiplist_first(sl); node; node = node->right)
+
+/** Iterate over the nodes of a skip list in descending order */
+#define SKIPLIST_FOREACH_REVERSE(node, sl)                                     \
+  for (skiplist_node* node = skiplist_last(sl); node; node = node->left)
+
+#endif
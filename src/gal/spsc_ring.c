@@ -0,0 +1,190 @@
+#include "spsc_ring.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static size_t spsc_round_up_pow2(size_t n) {
+  size_t p = 1;
+  while (p < n)
+    p <<= 1;
+  return p;
+}
+
+spsc_ring* spsc_ring_init(size_t element_size, size_t capacity) {
+  assert(element_size > 0 && "spsc_ring_init");
+  assert(capacity > 0 && capacity <= SIZE_MAX / 2 && "spsc_ring_init");
+
+  spsc_ring* r = (spsc_ring*)aligned_alloc(_Alignof(spsc_ring),
+                                           sizeof(spsc_ring));
+  if (!r)
+    return NULL;
+
+  r->_element_size = element_size;
+  r->_capacity = spsc_round_up_pow2(capacity);
+  r->_mask = r->_capacity - 1;
+  r->_data = malloc(r->_capacity * element_size);
+  if (!r->_data) {
+    free(r);
+    return NULL;
+  }
+
+  atomic_init(&r->_head, 0);
+  atomic_init(&r->_tail, 0);
+  r->_tail_cache = 0;
+  r->_head_cache = 0;
+
+  return r;
+}
+
+void spsc_ring_deinit(spsc_ring* r) {
+  free(r->_data);
+  free(r);
+}
+
+size_t spsc_ring_capacity(spsc_ring* r) { return r->_capacity; }
+
+size_t spsc_ring_size(spsc_ring* r) {
+  size_t head = atomic_load_explicit(&r->_head, memory_order_acquire);
+  size_t tail = atomic_load_explicit(&r->_tail, memory_order_acquire);
+  return tail - head;
+}
+
+/* Number of free slots seen by the producer, refreshing the cached head only
+ * when fewer than `want` slots are known to be free. */
+static size_t spsc_free_slots(spsc_ring* r, size_t tail, size_t want) {
+  size_t free_slots = r->_capacity - (tail - r->_head_cache);
+  if (free_slots < want) {
+    r->_head_cache = atomic_load_explicit(&r->_head, memory_order_acquire);
+    free_slots = r->_capacity - (tail - r->_head_cache);
+  }
+  return free_slots;
+}
+
+/* Number of filled slots seen by the consumer, refreshing the cached tail
+ * only when fewer than `want` slots are known to be filled. */
+static size_t spsc_used_slots(spsc_ring* r, size_t head, size_t want) {
+  size_t used = r->_tail_cache - head;
+  if (used < want) {
+    r->_tail_cache = atomic_load_explicit(&r->_tail, memory_order_acquire);
+    used = r->_tail_cache - head;
+  }
+  return used;
+}
+
+int spsc_ring_push(spsc_ring* r, void const* item) {
+  size_t tail = atomic_load_explicit(&r->_tail, memory_order_relaxed);
+  if (spsc_free_slots(r, tail, 1) == 0)
+    return 0;
+
+  char* slot = (char*)r->_data + (tail & r->_mask) * r->_element_size;
+  memcpy(slot, item, r->_element_size);
+  atomic_store_explicit(&r->_tail, tail + 1, memory_order_release);
+  return 1;
+}
+
+int spsc_ring_pop(spsc_ring* r, void* item) {
+  size_t head = atomic_load_explicit(&r->_head, memory_order_relaxed);
+  if (spsc_used_slots(r, head, 1) == 0)
+    return 0;
+
+  char const* slot = (char*)r->_data + (head & r->_mask) * r->_element_size;
+  memcpy(item, slot, r->_element_size);
+  atomic_store_explicit(&r->_head, head + 1, memory_order_release);
+  return 1;
+}
+
+size_t spsc_ring_push_n(spsc_ring* r, void const* items, size_t n) {
+  size_t tail = atomic_load_explicit(&r->_tail, memory_order_relaxed);
+  size_t free_slots = spsc_free_slots(r, tail, n);
+  if (n > free_slots)
+    n = free_slots;
+  if (n == 0)
+    return 0;
+
+  size_t element_size = r->_element_size;
+  size_t start = tail & r->_mask;
+  size_t first = r->_capacity - start;
+  if (first > n)
+    first = n;
+
+  memcpy((char*)r->_data + start * element_size, items, first * element_size);
+  if (n > first) {
+    memcpy(r->_data, (char const*)items + first * element_size,
+           (n - first) * element_size);
+  }
+
+  atomic_store_explicit(&r->_tail, tail + n, memory_order_release);
+  return n;
+}
+
+size_t spsc_ring_pop_n(spsc_ring* r, void* items, size_t n) {
+  size_t head = atomic_load_explicit(&r->_head, memory_order_relaxed);
+  size_t used = spsc_used_slots(r, head, n);
+  if (n > used)
+    n = used;
+  if (n == 0)
+    return 0;
+
+  size_t element_size = r->_element_size;
+  size_t start = head & r->_mask;
+  size_t first = r->_capacity - start;
+  if (first > n)
+    first = n;
+
+  memcpy(items, (char*)r->_data + start * element_size, first * element_size);
+  if (n > first) {
+    memcpy((char*)items + first * element_size, r->_data,
+           (n - first) * element_size);
+  }
+
+  atomic_store_explicit(&r->_head, head + n, memory_order_release);
+  return n;
+}
+
+void* spsc_ring_reserve(spsc_ring* r, size_t n, size_t* count) {
+  size_t tail = atomic_load_explicit(&r->_tail, memory_order_relaxed);
+  size_t start = tail & r->_mask;
+  size_t contiguous = r->_capacity - start;
+  if (n > contiguous)
+    n = contiguous;
+
+  size_t free_slots = spsc_free_slots(r, tail, n);
+  if (n > free_slots)
+    n = free_slots;
+
+  *count = n;
+  if (n == 0)
+    return NULL;
+  return (char*)r->_data + start * r->_element_size;
+}
+
+void spsc_ring_commit(spsc_ring* r, size_t count) {
+  size_t tail = atomic_load_explicit(&r->_tail, memory_order_relaxed);
+  assert(count <= r->_capacity - (tail - r->_head_cache) &&
+         "spsc_ring_commit");
+  atomic_store_explicit(&r->_tail, tail + count, memory_order_release);
+}
+
+void const* spsc_ring_peek(spsc_ring* r, size_t n, size_t* count) {
+  size_t head = atomic_load_explicit(&r->_head, memory_order_relaxed);
+  size_t start = head & r->_mask;
+  size_t contiguous = r->_capacity - start;
+  if (n > contiguous)
+    n = contiguous;
+
+  size_t used = spsc_used_slots(r, head, n);
+  if (n > used)
+    n = used;
+
+  *count = n;
+  if (n == 0)
+    return NULL;
+  return (char const*)r->_data + start * r->_element_size;
+}
+
+void spsc_ring_release(spsc_ring* r, size_t count) {
+  size_t head = atomic_load_explicit(&r->_head, memory_order_relaxed);
+  assert(count <= r->_tail_cache - head && "spsc_ring_release");
+  atomic_store_explicit(&r->_head, head + count, memory_order_release);
+}
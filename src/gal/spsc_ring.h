@@ -0,0 +1,132 @@
+/** spsc_ring.h - bounded single-producer/single-consumer ring buffer */
+
+#ifndef GAL_SPSC_RING_H
+#define GAL_SPSC_RING_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+#include "platform.h"
+
+/** Lock-free ring buffer for exactly one producer and one consumer thread
+ *
+ * Elements are fixed-size blobs copied in and out, like in `vector`.
+ *
+ * Both counters grow monotonically and are reduced modulo capacity only when
+ * addressing the buffer. Each side keeps a cached copy of the other side's
+ * counter and re-reads the shared one only when the cached value says the
+ * ring is full (producer) or empty (consumer), so in the steady state a
+ * thread touches only its own cache line.
+ *
+ * @field _head
+ * Read counter, written only by the consumer
+ *
+ * @field _tail_cache
+ * Consumer's last observed value of `_tail`
+ *
+ * @field _tail
+ * Write counter, written only by the producer
+ *
+ * @field _head_cache
+ * Producer's last observed value of `_head`
+ */
+typedef struct {
+  size_t _element_size;
+  size_t _capacity;
+  size_t _mask;
+  void* _data;
+
+  _Alignas(GAL_CACHE_LINE_SIZE) atomic_size_t _head;
+  size_t _tail_cache;
+
+  _Alignas(GAL_CACHE_LINE_SIZE) atomic_size_t _tail;
+  size_t _head_cache;
+} spsc_ring;
+
+/** Create a ring
+ *
+ * Capacity is rounded up to the next power of two.
+ *
+ * Returns NULL if memory can not be allocated.
+ */
+spsc_ring* spsc_ring_init(size_t element_size, size_t capacity);
+
+/** Destroy a ring */
+void spsc_ring_deinit(spsc_ring* r);
+
+/** Get the capacity of a ring */
+size_t spsc_ring_capacity(spsc_ring* r);
+
+/** Get the number of elements in a ring
+ *
+ * The value is exact only when called from the producer or the consumer while
+ * the other side is idle; otherwise it is a snapshot.
+ */
+size_t spsc_ring_size(spsc_ring* r);
+
+/** Add an element to a ring (producer)
+ *
+ * Returns 1 if the element was added and 0 if the ring is full.
+ *
+ * Complexity: O(1)
+ */
+int spsc_ring_push(spsc_ring* r, void const* item);
+
+/** Remove an element from a ring (consumer)
+ *
+ * Copies the element to `item`. Returns 1 if an element was removed and 0 if
+ * the ring is empty.
+ *
+ * Complexity: O(1)
+ */
+int spsc_ring_pop(spsc_ring* r, void* item);
+
+/** Add up to n elements to a ring (producer)
+ *
+ * Copies as many elements as fit, using at most two `memcpy` calls.
+ *
+ * @returns number of elements added
+ */
+size_t spsc_ring_push_n(spsc_ring* r, void const* items, size_t n);
+
+/** Remove up to n elements from a ring (consumer)
+ *
+ * Copies as many elements as are available, using at most two `memcpy` calls.
+ *
+ * @returns number of elements removed
+ */
+size_t spsc_ring_pop_n(spsc_ring* r, void* items, size_t n);
+
+/** Reserve contiguous space for writing (producer)
+ *
+ * Returns a pointer to a writable span of `*count` elements, where `*count`
+ * is at most n. The span never wraps, so it may be shorter than the free
+ * space. If the ring is full, `*count` is 0 and NULL is returned.
+ *
+ * Elements become visible to the consumer only after `spsc_ring_commit`.
+ */
+void* spsc_ring_reserve(spsc_ring* r, size_t n, size_t* count);
+
+/** Publish `count` elements written to a reserved span (producer)
+ *
+ * `count` must not exceed the size of the last reserved span.
+ */
+void spsc_ring_commit(spsc_ring* r, size_t count);
+
+/** Get contiguous elements for reading (consumer)
+ *
+ * Returns a pointer to a readable span of `*count` elements, where `*count`
+ * is at most n. The span never wraps. If the ring is empty, `*count` is 0 and
+ * NULL is returned.
+ *
+ * Elements stay in the ring until `spsc_ring_release`.
+ */
+void const* spsc_ring_peek(spsc_ring* r, size_t n, size_t* count);
+
+/** Remove `count` elements obtained by `spsc_ring_peek` (consumer)
+ *
+ * `count` must not exceed the size of the last peeked span.
+ */
+void spsc_ring_release(spsc_ring* r, size_t count);
+
+#endif
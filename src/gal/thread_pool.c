@@ -0,0 +1,399 @@
+#include "thread_pool.h"
+#include "platform.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/** Number of chunks per worker picked by automatic grain selection */
+#define GAL_CHUNKS_PER_WORKER 8
+
+typedef struct {
+  void (*fn)(void*);
+  void* arg;
+  atomic_size_t* group;
+} gal_task;
+
+/* Deque of a worker: the owner works at the back (tail), thieves take from
+ * the front (head). Counters grow monotonically and are masked on access. */
+typedef struct {
+  _Alignas(GAL_CACHE_LINE_SIZE) pthread_mutex_t lock;
+  gal_task* tasks;
+  size_t capacity;
+  size_t head;
+  size_t tail;
+  pthread_t thread;
+  gal_thread_pool* pool;
+  size_t index;
+} gal_worker;
+
+struct gal_thread_pool {
+  size_t nthreads;
+  gal_worker* workers;
+
+  atomic_size_t queued;
+  atomic_size_t pending;
+  atomic_size_t sleeping;
+  atomic_size_t next;
+  atomic_int stop;
+
+  pthread_mutex_t lock;
+  pthread_cond_t wake;
+};
+
+/* A contiguous piece of a parallel loop */
+typedef struct {
+  void (*body)(size_t, size_t, void*);
+  void (*map)(size_t, size_t, void*, void*);
+  void* partial;
+  void* ctx;
+  size_t begin;
+  size_t end;
+} gal_chunk;
+
+static _Thread_local gal_worker* gal_current_worker;
+
+/* Terminates the program when the pool can not get memory for work that
+ * has already been handed to it */
+static void gal_out_of_memory(char const* func) {
+  fprintf(stderr, "%s: out of memory\n", func);
+  abort();
+}
+
+static void gal_deque_push(gal_worker* w, gal_task task) {
+  pthread_mutex_lock(&w->lock);
+
+  if (w->tail - w->head == w->capacity) {
+    size_t capacity = w->capacity * 2;
+    gal_task* tasks = malloc(capacity * sizeof(gal_task));
+    if (!tasks)
+      gal_out_of_memory("gal_thread_pool_submit");
+    for (size_t i = w->head; i != w->tail; ++i) {
+      tasks[i - w->head] = w->tasks[i & (w->capacity - 1)];
+    }
+    free(w->tasks);
+    w->tasks = tasks;
+    w->tail -= w->head;
+    w->head = 0;
+    w->capacity = capacity;
+  }
+
+  w->tasks[w->tail & (w->capacity - 1)] = task;
+  w->tail += 1;
+
+  pthread_mutex_unlock(&w->lock);
+}
+
+static int gal_deque_pop_back(gal_worker* w, gal_task* task) {
+  int found = 0;
+  pthread_mutex_lock(&w->lock);
+  if (w->tail != w->head) {
+    w->tail -= 1;
+    *task = w->tasks[w->tail & (w->capacity - 1)];
+    found = 1;
+  }
+  pthread_mutex_unlock(&w->lock);
+  return found;
+}
+
+static int gal_deque_pop_front(gal_worker* w, gal_task* task) {
+  int found = 0;
+  pthread_mutex_lock(&w->lock);
+  if (w->tail != w->head) {
+    *task = w->tasks[w->head & (w->capacity - 1)];
+    w->head += 1;
+    found = 1;
+  }
+  pthread_mutex_unlock(&w->lock);
+  return found;
+}
+
+/* Takes a task from the own deque if the caller is a worker of this pool,
+ * otherwise steals one, starting from a varying victim. */
+static int gal_find_task(gal_thread_pool* pool, gal_task* task) {
+  if (atomic_load(&pool->queued) == 0)
+    return 0;
+
+  gal_worker* self = gal_current_worker;
+  size_t start;
+  if (self && self->pool == pool) {
+    if (gal_deque_pop_back(self, task))
+      goto found;
+    start = self->index + 1;
+  } else {
+    start = atomic_fetch_add_explicit(&pool->next, 1, memory_order_relaxed);
+  }
+
+  for (size_t i = 0; i < pool->nthreads; ++i) {
+    gal_worker* victim = &pool->workers[(start + i) % pool->nthreads];
+    if (victim != self && gal_deque_pop_front(victim, task))
+      goto found;
+  }
+  return 0;
+
+found:
+  atomic_fetch_sub(&pool->queued, 1);
+  return 1;
+}
+
+static void gal_run_task(gal_thread_pool* pool, gal_task* task) {
+  task->fn(task->arg);
+  if (task->group)
+    atomic_fetch_sub_explicit(task->group, 1, memory_order_release);
+  atomic_fetch_sub_explicit(&pool->pending, 1, memory_order_release);
+}
+
+static void gal_submit_task(gal_thread_pool* pool, gal_task task) {
+  gal_worker* w = gal_current_worker;
+  if (!w || w->pool != pool) {
+    size_t next =
+        atomic_fetch_add_explicit(&pool->next, 1, memory_order_relaxed);
+    w = &pool->workers[next % pool->nthreads];
+  }
+
+  atomic_fetch_add_explicit(&pool->pending, 1, memory_order_relaxed);
+  gal_deque_push(w, task);
+  atomic_fetch_add(&pool->queued, 1);
+
+  if (atomic_load(&pool->sleeping) > 0) {
+    pthread_mutex_lock(&pool->lock);
+    pthread_cond_signal(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+  }
+}
+
+/* Runs queued tasks until the counter drops to zero */
+static void gal_help_until_zero(gal_thread_pool* pool,
+                                atomic_size_t* counter) {
+  gal_task task;
+  while (atomic_load_explicit(counter, memory_order_acquire) > 0) {
+    if (gal_find_task(pool, &task))
+      gal_run_task(pool, &task);
+    else
+      sched_yield();
+  }
+}
+
+static void* gal_worker_main(void* arg) {
+  gal_worker* self = arg;
+  gal_thread_pool* pool = self->pool;
+  gal_current_worker = self;
+
+  gal_task task;
+  for (;;) {
+    if (gal_find_task(pool, &task)) {
+      gal_run_task(pool, &task);
+      continue;
+    }
+
+    /* Announce the intent to sleep before checking for work, so that a
+     * submitter either sees the sleeper or the sleeper sees the task. */
+    atomic_fetch_add(&pool->sleeping, 1);
+    pthread_mutex_lock(&pool->lock);
+    while (!atomic_load(&pool->stop) && atomic_load(&pool->queued) == 0) {
+      pthread_cond_wait(&pool->wake, &pool->lock);
+    }
+    int stop = atomic_load(&pool->stop) && atomic_load(&pool->queued) == 0;
+    pthread_mutex_unlock(&pool->lock);
+    atomic_fetch_sub(&pool->sleeping, 1);
+
+    if (stop)
+      break;
+  }
+
+  gal_current_worker = NULL;
+  return NULL;
+}
+
+/* Stops and joins the first `started` workers and frees the pool */
+static void gal_thread_pool_release(gal_thread_pool* pool, size_t started) {
+  pthread_mutex_lock(&pool->lock);
+  atomic_store(&pool->stop, 1);
+  pthread_cond_broadcast(&pool->wake);
+  pthread_mutex_unlock(&pool->lock);
+
+  for (size_t i = 0; i < started; ++i) {
+    pthread_join(pool->workers[i].thread, NULL);
+  }
+  for (size_t i = 0; i < pool->nthreads; ++i) {
+    pthread_mutex_destroy(&pool->workers[i].lock);
+    free(pool->workers[i].tasks);
+  }
+
+  pthread_cond_destroy(&pool->wake);
+  pthread_mutex_destroy(&pool->lock);
+  free(pool->workers);
+  free(pool);
+}
+
+gal_thread_pool* gal_thread_pool_init(size_t nthreads) {
+  if (nthreads == 0) {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    nthreads = online > 0 ? (size_t)online : 1;
+  }
+
+  gal_thread_pool* pool = malloc(sizeof(gal_thread_pool));
+  if (!pool)
+    return NULL;
+
+  pool->nthreads = nthreads;
+  pool->workers =
+      aligned_alloc(_Alignof(gal_worker), nthreads * sizeof(gal_worker));
+  if (!pool->workers) {
+    free(pool);
+    return NULL;
+  }
+
+  atomic_init(&pool->queued, 0);
+  atomic_init(&pool->pending, 0);
+  atomic_init(&pool->sleeping, 0);
+  atomic_init(&pool->next, 0);
+  atomic_init(&pool->stop, 0);
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->wake, NULL);
+
+  int failed = 0;
+  for (size_t i = 0; i < nthreads; ++i) {
+    gal_worker* w = &pool->workers[i];
+    pthread_mutex_init(&w->lock, NULL);
+    w->capacity = 64;
+    w->tasks = malloc(w->capacity * sizeof(gal_task));
+    failed |= !w->tasks;
+    w->head = 0;
+    w->tail = 0;
+    w->pool = pool;
+    w->index = i;
+  }
+  if (failed) {
+    gal_thread_pool_release(pool, 0);
+    return NULL;
+  }
+
+  for (size_t i = 0; i < nthreads; ++i) {
+    gal_worker* w = &pool->workers[i];
+    if (pthread_create(&w->thread, NULL, gal_worker_main, w) != 0) {
+      gal_thread_pool_release(pool, i);
+      return NULL;
+    }
+  }
+
+  return pool;
+}
+
+void gal_thread_pool_deinit(gal_thread_pool* pool) {
+  gal_thread_pool_wait(pool);
+  gal_thread_pool_release(pool, pool->nthreads);
+}
+
+size_t gal_thread_pool_size(gal_thread_pool* pool) { return pool->nthreads; }
+
+void gal_thread_pool_submit(gal_thread_pool* pool, void (*fn)(void*),
+                            void* arg) {
+  gal_task task = {fn, arg, NULL};
+  gal_submit_task(pool, task);
+}
+
+void gal_thread_pool_wait(gal_thread_pool* pool) {
+  gal_help_until_zero(pool, &pool->pending);
+}
+
+static void gal_run_chunk(void* arg) {
+  gal_chunk* chunk = arg;
+  if (chunk->map)
+    chunk->map(chunk->begin, chunk->end, chunk->partial, chunk->ctx);
+  else
+    chunk->body(chunk->begin, chunk->end, chunk->ctx);
+}
+
+static size_t gal_pick_grain(gal_thread_pool* pool, size_t n, size_t grain) {
+  if (grain > 0)
+    return grain;
+
+  grain = n / (pool->nthreads * GAL_CHUNKS_PER_WORKER);
+  return grain > 0 ? grain : 1;
+}
+
+/* Splits the range into chunks sharing the template `proto`, runs them on
+ * the pool and waits for completion. Partial results, if any, are laid out
+ * in `partials` with a stride of `partial_size`. */
+static void gal_run_chunks(gal_thread_pool* pool, size_t begin, size_t end,
+                           size_t grain, gal_chunk proto, char* partials,
+                           size_t partial_size, char const* func) {
+  size_t n = end - begin;
+  size_t nchunks = (n + grain - 1) / grain;
+
+  gal_chunk* chunks = malloc(nchunks * sizeof(gal_chunk));
+  if (!chunks)
+    gal_out_of_memory(func);
+
+  atomic_size_t group;
+  atomic_init(&group, nchunks);
+
+  for (size_t i = 0; i < nchunks; ++i) {
+    chunks[i] = proto;
+    chunks[i].begin = begin + i * grain;
+    chunks[i].end = i + 1 == nchunks ? end : chunks[i].begin + grain;
+    if (partials)
+      chunks[i].partial = partials + i * partial_size;
+
+    gal_task task = {gal_run_chunk, &chunks[i], &group};
+    gal_submit_task(pool, task);
+  }
+
+  gal_help_until_zero(pool, &group);
+  free(chunks);
+}
+
+void gal_parallel_for(gal_thread_pool* pool, size_t begin, size_t end,
+                      size_t grain,
+                      void (*body)(size_t, size_t, void*), void* ctx) {
+  if (begin >= end)
+    return;
+
+  size_t n = end - begin;
+  if (!pool || pool->nthreads < 2 || n <= grain) {
+    body(begin, end, ctx);
+    return;
+  }
+
+  grain = gal_pick_grain(pool, n, grain);
+  gal_chunk proto = {body, NULL, NULL, ctx, 0, 0};
+  gal_run_chunks(pool, begin, end, grain, proto, NULL, 0, "gal_parallel_for");
+}
+
+void gal_parallel_reduce(gal_thread_pool* pool, size_t begin, size_t end,
+                         size_t grain, void* result, size_t result_size,
+                         void (*map)(size_t, size_t, void*, void*),
+                         void (*combine)(void*, void const*, void*),
+                         void* ctx) {
+  if (begin >= end)
+    return;
+
+  size_t n = end - begin;
+  if (!pool || pool->nthreads < 2 || n <= grain) {
+    map(begin, end, result, ctx);
+    return;
+  }
+
+  grain = gal_pick_grain(pool, n, grain);
+  size_t nchunks = (n + grain - 1) / grain;
+
+  char* partials = malloc(nchunks * result_size);
+  if (!partials)
+    gal_out_of_memory("gal_parallel_reduce");
+  for (size_t i = 0; i < nchunks; ++i) {
+    memcpy(partials + i * result_size, result, result_size);
+  }
+
+  gal_chunk proto = {NULL, map, NULL, ctx, 0, 0};
+  gal_run_chunks(pool, begin, end, grain, proto, partials, result_size,
+                 "gal_parallel_reduce");
+
+  for (size_t i = 0; i < nchunks; ++i) {
+    combine(result, partials + i * result_size, ctx);
+  }
+  free(partials);
+}
@@ -0,0 +1,85 @@
+/** thread_pool.h - work-stealing thread pool and parallel loops */
+
+#ifndef GAL_THREAD_POOL_H
+#define GAL_THREAD_POOL_H
+
+#include <stddef.h>
+
+/** Work-stealing thread pool
+ *
+ * Every worker owns a deque of tasks. A worker pushes and pops tasks at the
+ * back of its own deque and, when it runs dry, steals from the front of the
+ * other workers' deques. Threads that wait for a task group (including
+ * workers running nested parallel loops) execute queued tasks instead of
+ * blocking, so nested parallelism does not deadlock.
+ *
+ * Available only if the library is built with GAL_THREADS.
+ */
+typedef struct gal_thread_pool gal_thread_pool;
+
+/** Create a thread pool
+ *
+ * If nthreads is 0, one worker per online processor is started.
+ *
+ * Returns NULL if memory can not be allocated or a worker thread can not be
+ * started; workers started up to then are stopped again.
+ */
+gal_thread_pool* gal_thread_pool_init(size_t nthreads);
+
+/** Destroy a thread pool
+ *
+ * Waits for all submitted tasks to finish and joins the workers.
+ */
+void gal_thread_pool_deinit(gal_thread_pool* pool);
+
+/** Get the number of workers in a pool */
+size_t gal_thread_pool_size(gal_thread_pool* pool);
+
+/** Submit a task
+ *
+ * Called from a worker, the task goes to that worker's deque; otherwise
+ * deques are picked round-robin. Terminates the program if a deque can not
+ * grow.
+ */
+void gal_thread_pool_submit(gal_thread_pool* pool, void (*fn)(void*),
+                            void* arg);
+
+/** Wait until all submitted tasks are finished
+ *
+ * The calling thread executes queued tasks while it waits.
+ */
+void gal_thread_pool_wait(gal_thread_pool* pool);
+
+/** Run a loop body over an index range in parallel
+ *
+ * The range [begin, end) is split into chunks of about `grain` indices and
+ * `body(chunk_begin, chunk_end, ctx)` is called once per chunk. If grain is
+ * 0, it is chosen so that every worker gets several chunks to balance load.
+ * The function returns when all chunks are done.
+ *
+ * If pool is NULL, the whole range is run on the calling thread. Terminates
+ * the program if memory for the chunks can not be allocated.
+ */
+void gal_parallel_for(gal_thread_pool* pool, size_t begin, size_t end,
+                      size_t grain,
+                      void (*body)(size_t, size_t, void*), void* ctx);
+
+/** Reduce an index range in parallel
+ *
+ * On entry `result` must hold the identity element of the reduction; it is
+ * `result_size` bytes long. Every chunk starts from a copy of the identity
+ * and is folded by `map(chunk_begin, chunk_end, partial, ctx)`. Partial
+ * results are then folded into `result` in index order with
+ * `combine(result, partial, ctx)`, so `combine` needs to be associative but
+ * not commutative.
+ *
+ * Grain selection, NULL pool and allocation failure are handled as in
+ * `gal_parallel_for`.
+ */
+void gal_parallel_reduce(gal_thread_pool* pool, size_t begin, size_t end,
+                         size_t grain, void* result, size_t result_size,
+                         void (*map)(size_t, size_t, void*, void*),
+                         void (*combine)(void*, void const*, void*),
+                         void* ctx);
+
+#endif
@@ -1,73 +1,253 @@
 #include "vector.h"
+#include "vector_mmap.h"
 #include <assert.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+/* Allocates through the vector's allocator, recording the call if
+ * statistics are enabled */
+static void* vector_allocate(vector* v, void* ptr, size_t old_size,
+                             size_t new_size) {
+#ifdef GAL_ALLOC_STATS
+  return gal_stats_allocate(&v->_stats, v->_allocator, ptr, old_size,
+                            new_size);
+#else
+  return v->_allocator(ptr, old_size, new_size);
+#endif
+}
+
+/* Terminates the program when a vector can not get memory */
+static void vector_out_of_memory(char const* func) {
+  fprintf(stderr, "%s: out of memory\n", func);
+  abort();
+}
+
+/* Allocates a block for an element copy that is handed to the caller */
+static void* vector_allocate_copy(vector* v, char const* func) {
+#ifdef GAL_ALLOC_STATS
+  gal_stats_record_copy(&v->_stats, v->_element_size);
+#endif
+  void* el = malloc(v->_element_size);
+  if (!el)
+    vector_out_of_memory(func);
+  return el;
+}
+
+/* Capacity to grow to so that at least `min_capacity` elements fit */
+static size_t vector_grown_capacity(vector* v, size_t min_capacity) {
+  size_t capacity = v->_capacity * 2;
+  if (capacity < v->_capacity || capacity < min_capacity)
+    capacity = min_capacity;
+  return capacity;
+}
+
+/* Fixed-width element kernels; a memcpy of constant size compiles to plain
+ * loads and stores instead of a library call */
+#define VECTOR_KERNELS(width)                                                  \
+  static void vector_copy_##width(void* dst, void const* src, size_t size) {  \
+    (void)size;                                                                \
+    memcpy(dst, src, width);                                                   \
+  }                                                                            \
+  static void vector_swap_##width(void* a, void* b, size_t size) {            \
+    (void)size;                                                                \
+    unsigned char tmp[width];                                                  \
+    memcpy(tmp, a, width);                                                     \
+    memcpy(a, b, width);                                                       \
+    memcpy(b, tmp, width);                                                     \
+  }
+
+VECTOR_KERNELS(1)
+VECTOR_KERNELS(2)
+VECTOR_KERNELS(4)
+VECTOR_KERNELS(8)
+VECTOR_KERNELS(16)
+
+#undef VECTOR_KERNELS
+
+static void vector_copy_generic(void* dst, void const* src, size_t size) {
+  memcpy(dst, src, size);
+}
+
+/* Swaps 16 bytes at a time through registers, then the remaining bytes */
+static void vector_swap_generic(void* a, void* b, size_t size) {
+  char* x = a;
+  char* y = b;
+  for (; size >= 16; x += 16, y += 16, size -= 16) {
+    vector_swap_16(x, y, 16);
+  }
+  for (; size > 0; ++x, ++y, --size) {
+    char tmp = *x;
+    *x = *y;
+    *y = tmp;
+  }
+}
+
+void _vector_init_kernels(vector* v) {
+  switch (v->_element_size) {
+  case 1:
+    v->_copy = vector_copy_1, v->_swap = vector_swap_1;
+    break;
+  case 2:
+    v->_copy = vector_copy_2, v->_swap = vector_swap_2;
+    break;
+  case 4:
+    v->_copy = vector_copy_4, v->_swap = vector_swap_4;
+    break;
+  case 8:
+    v->_copy = vector_copy_8, v->_swap = vector_swap_8;
+    break;
+  case 16:
+    v->_copy = vector_copy_16, v->_swap = vector_swap_16;
+    break;
+  default:
+    v->_copy = vector_copy_generic, v->_swap = vector_swap_generic;
+    break;
+  }
+}
+
 vector* vector_init(size_t element_size) {
+  return vector_init_with_allocator(element_size, gal_std_allocator);
+}
+
+vector* vector_init_with_allocator(size_t element_size,
+                                   gal_allocator allocator) {
   vector* v = (vector*)malloc(sizeof(vector));
+  if (!v)
+    return NULL;
 
   v->_element_size = element_size;
+  _vector_init_kernels(v);
   v->_size = 0;
   v->_capacity = 16;
   v->_max_capacity = VECTOR_MAX_SIZE;
-  v->_data = malloc(v->_element_size * v->_capacity);
+  v->_allocator = allocator;
+  v->_mapping = NULL;
+#ifdef GAL_ALLOC_STATS
+  memset(&v->_stats, 0, sizeof(v->_stats));
+#endif
+  v->_data = vector_allocate(v, NULL, 0, v->_element_size * v->_capacity);
+  if (!v->_data) {
+    free(v);
+    errno = ENOMEM;
+    return NULL;
+  }
 
   return v;
 }
 
 void vector_deinit(vector* v) {
-  if (v->_data) {
-    free(v->_data);
+  if (v->_mapping) {
+    _vector_mmap_close(v);
+  } else if (v->_data) {
+    vector_allocate(v, v->_data, v->_capacity * v->_element_size, 0);
   }
 
   free(v);
 }
 
+gal_alloc_stats const* vector_alloc_stats(vector* v) {
+#ifdef GAL_ALLOC_STATS
+  return &v->_stats;
+#else
+  (void)v;
+  return NULL;
+#endif
+}
+
 size_t vector_size(vector* v) { return v->_size; }
 
 size_t vector_capacity(vector* v) { return v->_capacity; }
 
+size_t vector_element_size(vector* v) { return v->_element_size; }
+
 int vector_is_empty(vector* v) { return v->_size == 0; }
 
 void* vector_at(vector* v, size_t index) {
   assert(index < v->_size && "vector_at");
 #ifdef NDEBUG
-  if (index < v->_size) {
-    return NULL
+  if (index >= v->_size) {
+    return NULL;
   }
 #endif
 
-  return (char*)v->_data + index * v->_element_size;
+  return vector_at_unchecked(v, index);
 }
 
 void vector_push(vector* v, void const* item) {
-  if (v->_size == v->_capacity) {
-    vector_resize(v, v->_capacity * 2);
-  }
+  if (vector_try_push(v, item) != 0)
+    vector_out_of_memory("vector_push");
+}
 
-  char* data = (char*)v->_data + v->_size * v->_element_size;
-  memcpy(data, item, v->_element_size);
+int vector_try_push(vector* v, void const* item) {
+  if (v->_size == v->_capacity &&
+      vector_try_resize(v, vector_grown_capacity(v, v->_size + 1)) != 0)
+    return -1;
+
+  _vector_copy_element(v, vector_end(v), item);
   v->_size += 1;
+  return 0;
 }
 
-void vector_insert(vector* v, void const* item, size_t index) {
-  if (v->_size == v->_capacity) {
-    vector_resize(v, v->_capacity * 2);
+/* Makes room for n more elements with at most one resize */
+static int vector_try_grow(vector* v, size_t n) {
+  if (n > SIZE_MAX - v->_size) {
+    errno = ENOMEM;
+    return -1;
   }
+  if (v->_size + n <= v->_capacity)
+    return 0;
+  return vector_try_resize(v, vector_grown_capacity(v, v->_size + n));
+}
 
-  size_t element_size = v->_element_size;
-  char* dest;
-  char* src;
+void vector_push_n(vector* v, void const* items, size_t n) {
+  if (n == 0)
+    return;
+  if (vector_try_grow(v, n) != 0)
+    vector_out_of_memory("vector_push_n");
 
-  for (size_t i = v->_size; i > index; --i) {
-    dest = (char*)v->_data + i * element_size;
-    src = (char*)v->_data + (i - 1) * element_size;
-    memcpy(dest, src, element_size);
-  }
+  memcpy(vector_end(v), items, n * v->_element_size);
+  v->_size += n;
+}
+
+void vector_extend(vector* v, vector* other) {
+  assert(v->_element_size == other->_element_size && "vector_extend");
+  /* other may be v itself, so its size is read before growing */
+  size_t n = other->_size;
+  if (vector_try_grow(v, n) != 0)
+    vector_out_of_memory("vector_extend");
+
+  if (n > 0)
+    memcpy(vector_end(v), vector_data(other), n * v->_element_size);
+  v->_size += n;
+}
+
+void* vector_emplace_back(vector* v) {
+  if (vector_try_grow(v, 1) != 0)
+    vector_out_of_memory("vector_emplace_back");
 
   v->_size += 1;
+  return vector_at_unchecked(v, v->_size - 1);
+}
+
+void vector_insert(vector* v, void const* item, size_t index) {
+  if (vector_try_insert(v, item, index) != 0)
+    vector_out_of_memory("vector_insert");
+}
 
-  memcpy(src, item, element_size);
+int vector_try_insert(vector* v, void const* item, size_t index) {
+  if (v->_size == v->_capacity &&
+      vector_try_resize(v, vector_grown_capacity(v, v->_size + 1)) != 0)
+    return -1;
+
+  size_t element_size = v->_element_size;
+  char* slot = vector_at_unchecked(v, index);
+  memmove(slot + element_size, slot, (v->_size - index) * element_size);
+  _vector_copy_element(v, slot, item);
+  v->_size += 1;
+  return 0;
 }
 
 void vector_prepend(vector* v, void const* item) { vector_insert(v, item, 0); }
@@ -75,14 +255,13 @@ void vector_prepend(vector* v, void const* item) { vector_insert(v, item, 0); }
 void* vector_pop(vector* v) {
   assert(!vector_is_empty(v) && "vector_pop");
 
-  size_t element_size = v->_element_size;
-  void* el = malloc(element_size);
-  void* data = (char*)v->_data + (v->_size - 1) * element_size;
-  memcpy(el, data, element_size);
+  void* el = vector_allocate_copy(v, "vector_pop");
+  v->_copy(el, vector_at_unchecked(v, v->_size - 1), v->_element_size);
   v->_size -= 1;
 
+  /* a failed shrink keeps the larger buffer */
   if (v->_size == v->_capacity / 2) {
-    vector_resize(v, v->_capacity / 2);
+    vector_try_resize(v, v->_capacity / 2);
   }
 
   return el;
@@ -91,23 +270,14 @@ void* vector_pop(vector* v) {
 void* vector_pop_front(vector* v) {
   assert(!vector_is_empty(v) && "vector_pop");
 
-  void* el = malloc(v->_element_size);
-  memcpy(el, v->_data, v->_element_size);
-
-  size_t element_size = v->_element_size;
-  char* src;
-  char* dest;
-
-  for (size_t i = 1; i < v->_size; ++i) {
-    dest = (char*)v->_data + (i - 1) * element_size;
-    src = (char*)v->_data + i * element_size;
-    memcpy(dest, src, element_size);
-  }
+  void* el = vector_allocate_copy(v, "vector_pop_front");
+  v->_copy(el, v->_data, v->_element_size);
 
   v->_size -= 1;
+  memmove(v->_data, vector_at_unchecked(v, 1), v->_size * v->_element_size);
 
   if (v->_size == v->_capacity / 2) {
-    vector_resize(v, v->_capacity / 2);
+    vector_try_resize(v, v->_capacity / 2);
   }
 
   return el;
@@ -117,38 +287,45 @@ void vector_delete(vector* v, size_t index) {
   assert(index < v->_size && "vector_delete");
 
   size_t element_size = v->_element_size;
-  char* src;
-  char* dest;
-
-  for (size_t i = index + 1; i < v->_size; ++i) {
-    src = (char*)v->_data + i * element_size;
-    dest = (char*)v->_data + (i - 1) * element_size;
-    memcpy(dest, src, element_size);
-  }
-
+  char* slot = vector_at_unchecked(v, index);
   v->_size -= 1;
+  memmove(slot, slot + element_size, (v->_size - index) * element_size);
 
   if (v->_size == v->_capacity / 2) {
-    vector_resize(v, v->_capacity / 2);
+    vector_try_resize(v, v->_capacity / 2);
   }
 }
 
 void vector_remove(vector* v, int (*predicate)(void const*)) {
-  size_t element_size = v->_element_size;
-  char* el;
-  for (size_t i = 0; i < v->_size; ++i) {
-    el = (char*)v->_data + i * element_size;
-    if (predicate(el)) {
-      vector_delete(v, i);
-    }
+  size_t size = v->_size;
+  size_t kept = 0;
+
+  /* Moves every kept element into place once */
+  for (size_t i = 0; i < size; ++i) {
+    char* el = vector_at_unchecked(v, i);
+    if (predicate(el))
+      continue;
+    if (kept != i)
+      v->_copy(vector_at_unchecked(v, kept), el, v->_element_size);
+    kept += 1;
   }
+  v->_size = kept;
+
+  /* Shrink as far as deleting the elements one by one would; that stops at
+   * capacity 0 when every element goes */
+  size_t capacity = v->_capacity;
+  while (capacity > 0 && kept <= capacity / 2 && capacity / 2 < size) {
+    capacity /= 2;
+  }
+  vector_try_resize(v, capacity);
 }
 
+void vector_clear(vector* v) { v->_size = 0; }
+
 size_t vector_find(vector* v, int (*predicate)(void const*)) {
-  size_t element_size = v->_element_size;
-  char* el;
-  for (size_t i = 0; i < v->_size; ++i) {
-    el = (char*)v->_data + i * element_size;
+  char* el = vector_begin(v);
+  char* end = vector_end(v);
+  for (size_t i = 0; el != end; ++i, el += v->_element_size) {
     if (predicate(el)) {
       return i;
     }
@@ -157,20 +334,52 @@ size_t vector_find(vector* v, int (*predicate)(void const*)) {
 }
 
 void vector_resize(vector* v, size_t capacity) {
-  assert(capacity < v->_max_capacity && "vector_resize");
-  assert(v->_size <= capacity && "vector_resize");
+  if (vector_try_resize(v, capacity) != 0)
+    vector_out_of_memory("vector_resize");
+}
+
+int vector_try_resize(vector* v, size_t capacity) {
+  assert(capacity < v->_max_capacity && "vector_try_resize");
+  assert(v->_size <= capacity && "vector_try_resize");
 
   if (capacity == v->_capacity) {
-    return;
+    return 0;
+  }
+
+  if (capacity > SIZE_MAX / v->_element_size) {
+    errno = ENOMEM;
+    return -1;
+  }
+
+  if (v->_mapping) {
+    return _vector_mmap_resize(v, capacity);
   }
 
-  v->_data = realloc(v->_data, capacity * v->_element_size);
+  void* data = vector_allocate(v, v->_data, v->_capacity * v->_element_size,
+                               capacity * v->_element_size);
+  if (!data && capacity > 0) {
+    errno = ENOMEM;
+    return -1;
+  }
+
+  v->_data = data;
   v->_capacity = capacity;
+  return 0;
+}
+
+void vector_reserve(vector* v, size_t capacity) {
+  if (vector_try_reserve(v, capacity) != 0)
+    vector_out_of_memory("vector_reserve");
+}
+
+int vector_try_reserve(vector* v, size_t capacity) {
+  if (capacity <= v->_capacity)
+    return 0;
+  return vector_try_resize(v, capacity);
 }
 
 void vector_replace(vector* v, size_t index, void const* data) {
-  char* start = (char*)v->_data + index * v->_element_size;
-  memcpy(start, data, v->_element_size);
+  v->_copy(vector_at_unchecked(v, index), data, v->_element_size);
 }
 
 static void _quicksort(vector* v, size_t start, size_t end,
@@ -191,24 +400,33 @@ void _quicksort(vector* v, size_t start, size_t end,
 
   // https://research.google/blog/extra-extra-read-all-about-it-nearly-all-binary-searches-and-mergesorts-are-broken/
   size_t pivot_idx = median_of_three(start, (start + end) >> 1, end);
-  void* pivot = vector_at(v, pivot_idx);
   size_t i = start, j = end;
-  void* tmp = malloc(v->_element_size);
+
+  size_t element_size = v->_element_size;
+
+  /* The pivot slot takes part in swaps, so compare against a copy; only
+   * large elements need it on the heap */
+  _Alignas(max_align_t) unsigned char buffer[64];
+  void* pivot = element_size <= sizeof(buffer) ? buffer : malloc(element_size);
+  if (!pivot)
+    vector_out_of_memory("vector_quicksort");
+  _vector_copy_element(v, pivot, vector_at_unchecked(v, pivot_idx));
 
   while (i <= j) {
-    while (cmp(vector_at(v, i), pivot) < 0)
+    while (cmp(vector_at_unchecked(v, i), pivot) < 0)
       ++i;
-    while (cmp(vector_at(v, j), pivot) > 0)
+    while (cmp(vector_at_unchecked(v, j), pivot) > 0)
       --j;
 
     if (i <= j) {
-      memcpy(tmp, vector_at(v, i), v->_element_size);
-      vector_replace(v, i, vector_at(v, j));
-      vector_replace(v, j, tmp);
+      if (i != j)
+        _vector_swap_elements(v, vector_at_unchecked(v, i),
+                              vector_at_unchecked(v, j));
       ++i, --j;
     }
   }
-  free(tmp);
+  if (pivot != buffer)
+    free(pivot);
 
   if (start < j)
     _quicksort(v, start, j, cmp);
@@ -229,15 +447,16 @@ size_t vector_bsearch(vector* v, void const* key,
   if (vector_is_empty(v))
     return VECTOR_NPOS;
 
-  size_t start = 0, end = vector_size(v) - 1, mid;
+  /* Searches [start, end), so `end` never steps below the first element */
+  size_t start = 0, end = vector_size(v), mid;
 
-  while (start <= end) {
+  while (start < end) {
     mid = start + ((end - start) >> 1);
-    int compare = cmp(key, vector_at(v, mid));
+    int compare = cmp(key, vector_at_unchecked(v, mid));
     if (compare > 0)
       start = mid + 1;
     else if (compare < 0)
-      end = mid - 1;
+      end = mid;
     else
       return mid;
   }
@@ -253,7 +472,7 @@ int vector_cmp(vector* a, vector* b, int (*cmp)(void const*, void const*)) {
 
   int result = 0;
   for (size_t i = 0; i < a->_size; ++i) {
-    result = cmp(vector_at(a, i), vector_at(b, i));
+    result = cmp(vector_at_unchecked(a, i), vector_at_unchecked(b, i));
     if (result != 0)
       return result;
   }
@@ -4,27 +4,76 @@
 #define VECTOR_H
 
 #include <stddef.h>
+#include <string.h>
+
+#include "allocator.h"
 
 #define VECTOR_MAX_SIZE ((size_t) - 1)
 #define VECTOR_NPOS ((size_t) - 2)
 
+struct vector_mapping;
+
+/** Copy one element between two non-overlapping locations */
+typedef void (*vector_copy_fn)(void* dst, void const* src, size_t size);
+
+/** Exchange two distinct elements */
+typedef void (*vector_swap_fn)(void* a, void* b, size_t size);
+
+/** Mutable array of fixed-size elements
+ *
+ * @field _copy
+ * Element copy routine chosen for the element size when the vector is
+ * created; fixed-width for 1, 2, 4, 8 and 16 bytes, `memcpy` otherwise.
+ * The hot paths go through `_vector_copy_element` and call it only for the
+ * other sizes.
+ *
+ * @field _swap
+ * Element swap routine chosen the same way, swapping through registers
+ * instead of a temporary allocation
+ */
 typedef struct {
   size_t _element_size;
   size_t _size;
   size_t _capacity;
   size_t _max_capacity;
   void* _data;
+  vector_copy_fn _copy;
+  vector_swap_fn _swap;
+  gal_allocator _allocator;
+  struct vector_mapping* _mapping;
+#ifdef GAL_ALLOC_STATS
+  gal_alloc_stats _stats;
+#endif
 } vector;
 
-/** Create a new vector */
+/** Create a new vector
+ *
+ * Returns NULL if memory can not be allocated.
+ */
 vector* vector_init(size_t element_size);
 
+/** Create a new vector whose buffer comes from the given allocator
+ *
+ * Pass `gal_tiered_allocator` to back buffers above
+ * GAL_LARGE_ALLOC_THRESHOLD with huge pages.
+ *
+ * Returns NULL if memory can not be allocated.
+ */
+vector* vector_init_with_allocator(size_t element_size,
+                                   gal_allocator allocator);
+
 /** Destroy a vector
  *
  * Frees underlying array.
  */
 void vector_deinit(vector* v);
 
+/** Get allocation statistics of a vector
+ *
+ * Returns NULL unless the library is built with GAL_ALLOC_STATS.
+ */
+gal_alloc_stats const* vector_alloc_stats(vector* v);
+
 /** Get the size of a vector */
 size_t vector_size(vector* v);
 
@@ -35,6 +84,9 @@ size_t vector_size(vector* v);
  */
 size_t vector_capacity(vector* v);
 
+/** Get the size of an element of a vector in bytes */
+size_t vector_element_size(vector* v);
+
 /** Check if vector is empty
  *
  * Returns 1 if vector is empty and 0 otherwise.
@@ -44,24 +96,168 @@ int vector_is_empty(vector* v);
 /** Get an element at index
  *
  * Returns a pointer if index < size, otherwise causes program termination.
- * If NDEBUG is set, returns NULL pointer.
+ * If NDEBUG is set, returns NULL pointer for an index out of range.
  */
 void* vector_at(vector* v, size_t index);
 
+/** Get an element at index without bounds checking
+ *
+ * The index must be less than the size. Compiles down to an address
+ * computation.
+ */
+static inline void* vector_at_unchecked(vector* v, size_t index) {
+  return (char*)v->_data + index * v->_element_size;
+}
+
+/** Get the underlying array
+ *
+ * The pointer is invalidated when the vector is resized.
+ */
+static inline void* vector_data(vector* v) { return v->_data; }
+
+/** Get a pointer to the first element
+ *
+ * Together with `vector_end` forms a span of the elements that can be
+ * walked with a pointer advanced by the element size. Both pointers are
+ * invalidated when the vector is resized.
+ */
+static inline void* vector_begin(vector* v) { return v->_data; }
+
+/** Get a pointer past the last element */
+static inline void* vector_end(vector* v) {
+  return (char*)v->_data + v->_size * v->_element_size;
+}
+
+/** Iterate over the elements of a vector by pointer
+ *
+ * Declares `it` as a `type*` that walks from `vector_begin` to `vector_end`.
+ * The size of `type` must be the element size of the vector, and the vector
+ * must not be resized inside the loop.
+ *
+ *     VECTOR_FOREACH(int32_t, it, v) { sum += *it; }
+ */
+#define VECTOR_FOREACH(type, it, v)                                            \
+  for (type *it = (type*)vector_begin(v), *it##_end = (type*)vector_end(v);    \
+       it != it##_end; ++it)
+
+/** Contiguous range of vector elements
+ *
+ * A span does not own the elements. It is invalidated when the vector it
+ * refers to is resized.
+ *
+ * @field _begin
+ * Pointer to the first element
+ *
+ * @field _end
+ * Pointer past the last element
+ *
+ * @field _element_size
+ * Size of an element
+ */
+typedef struct {
+  char* _begin;
+  char* _end;
+  size_t _element_size;
+} vector_span;
+
+/** Get a span of all elements of a vector */
+static inline vector_span vector_span_of(vector* v) {
+  vector_span s = {(char*)vector_begin(v), (char*)vector_end(v),
+                   v->_element_size};
+  return s;
+}
+
+/** Get a span of `count` elements starting at `first`
+ *
+ * The range must lie within the vector.
+ */
+static inline vector_span vector_subspan(vector* v, size_t first,
+                                         size_t count) {
+  char* begin = (char*)vector_at_unchecked(v, first);
+  vector_span s = {begin, begin + count * v->_element_size, v->_element_size};
+  return s;
+}
+
+/** Get the number of elements in a span */
+static inline size_t vector_span_size(vector_span s) {
+  return (size_t)(s._end - s._begin) / s._element_size;
+}
+
+/** Get an element of a span without bounds checking */
+static inline void* vector_span_at(vector_span s, size_t index) {
+  return s._begin + index * s._element_size;
+}
+
+/** Iterate over the elements of a span of any element size
+ *
+ * Declares `it` as a `char*` that is advanced by the element size.
+ */
+#define VECTOR_SPAN_FOREACH(it, span)                                          \
+  for (char *it = (span)._begin, *it##_end = (span)._end; it != it##_end;      \
+       it += (span)._element_size)
+
 /** Add element to the end of a vector
+ *
+ * Terminates program if memory can not be allocated.
  *
  * Complexity: O(1), O(n) if the vector is resized
  */
 void vector_push(vector* v, void const* item);
 
+/** Add element to the end of a vector, reporting allocation failure
+ *
+ * Returns 0 on success and -1 with errno set to ENOMEM if the vector can not
+ * grow, in which case it is left unchanged.
+ *
+ * Complexity: O(1), O(n) if the vector is resized
+ */
+int vector_try_push(vector* v, void const* item);
+
+/** Add n contiguous elements to the end of a vector
+ *
+ * The capacity is computed once, so the vector is resized at most once, and
+ * the elements are copied in one block. `items` must not point into the
+ * vector. Terminates program if memory can not be allocated.
+ *
+ * Complexity: O(n)
+ */
+void vector_push_n(vector* v, void const* items, size_t n);
+
+/** Append all elements of another vector
+ *
+ * Both vectors must have the same element size; `other` may be `v` itself.
+ * Resizes at most once, like `vector_push_n`.
+ *
+ * Complexity: O(m), where m is the size of `other`
+ */
+void vector_extend(vector* v, vector* other);
+
+/** Add an uninitialized element to the end of a vector
+ *
+ * Returns a pointer to the new element so that it can be constructed in
+ * place, without a temporary copy. The pointer is invalidated when the
+ * vector is resized. Terminates program if memory can not be allocated.
+ *
+ * Complexity: O(1), O(n) if the vector is resized
+ */
+void* vector_emplace_back(vector* v);
+
 /** Insert element at index
  *
  * Inserts element at `index` and shifts trailing elements right.
+ * Terminates program if memory can not be allocated.
  *
  * Complexity: O(n) in common case, O(n^2) if the vector is resized
  */
 void vector_insert(vector* v, void const* item, size_t index);
 
+/** Insert element at index, reporting allocation failure
+ *
+ * Returns 0 on success and -1 with errno set to ENOMEM if the vector can not
+ * grow, in which case it is left unchanged.
+ */
+int vector_try_insert(vector* v, void const* item, size_t index);
+
 /** Prepend element to the beginning
  *
  * Inserts element at index 0 and shifts trailing elements right.
@@ -74,7 +270,8 @@ void vector_prepend(vector* v, void const* item);
  *
  * Allocates memory to store the removed element and returns a pointer to it.
  *
- * Terminates program if the vector is empty.
+ * Terminates program if the vector is empty or if memory can not be
+ * allocated.
  *
  * Complexity: O(1) in common case, O(n) in case if vector is resized
  */
@@ -84,7 +281,8 @@ void* vector_pop(vector* v);
  *
  * Allocates memory to store the removed element and returns a pointer to it.
  *
- * Terminates program if the vector is empty.
+ * Terminates program if the vector is empty or if memory can not be
+ * allocated.
  *
  * Complexity: O(n) in common case, O(n) in case if vector is resized
  */
@@ -100,10 +298,20 @@ void vector_delete(vector* v, size_t index);
 
 /** Remove all elements on which predicate is true
  *
- * Complexity: O(n^2) in common case, O(n^3) if the vector is shrunk
+ * Keeps the order of the remaining elements.
+ *
+ * Complexity: O(n)
  */
 void vector_remove(vector* v, int (*predicate)(void const*));
 
+/** Remove all elements
+ *
+ * Keeps the capacity, so the vector can be refilled without allocating.
+ *
+ * Complexity: O(1)
+ */
+void vector_clear(vector* v);
+
 /** Return an index of the first element on which predicate is true
  *
  * If there is no element on which predicate returns true, VECTOR_NPOS is
@@ -114,11 +322,38 @@ void vector_remove(vector* v, int (*predicate)(void const*));
 size_t vector_find(vector* v, int (*predicate)(void const*));
 
 /** Resize vector to the new capacity
+ *
+ * Terminates program if memory can not be allocated.
  *
  * Complexity: O(n)
  */
 void vector_resize(vector* v, size_t capacity);
 
+/** Resize vector to the new capacity, reporting allocation failure
+ *
+ * Returns 0 on success and -1 with errno set on failure, in which case the
+ * vector is left unchanged.
+ *
+ * Complexity: O(n)
+ */
+int vector_try_resize(vector* v, size_t capacity);
+
+/** Make room for at least `capacity` elements
+ *
+ * Does nothing if the capacity is already large enough. Terminates program
+ * if memory can not be allocated.
+ *
+ * Complexity: O(n) if the vector is resized
+ */
+void vector_reserve(vector* v, size_t capacity);
+
+/** Make room for at least `capacity` elements, reporting allocation failure
+ *
+ * Returns 0 on success and -1 with errno set on failure, in which case the
+ * vector is left unchanged.
+ */
+int vector_try_reserve(vector* v, size_t capacity);
+
 /** Replace element at index */
 void vector_replace(vector* v, size_t idx, void const* data);
 
@@ -160,4 +395,66 @@ size_t vector_bsearch(vector* v, void const* key,
  */
 int vector_cmp(vector* a, vector* b, int (*cmp)(void const*, void const*));
 
+/** Choose the element copy and swap routines for the vector's element size
+ *
+ * Used by the functions that create vectors outside of `vector_init`.
+ */
+void _vector_init_kernels(vector* v);
+
+/** Copy one element between two non-overlapping locations
+ *
+ * Switches on the element size so that the common sizes become a
+ * fixed-size `memcpy`, which compiles to a load and a store, instead of an
+ * indirect call. Other sizes fall back to `_copy`.
+ */
+static inline void _vector_copy_element(vector const* v, void* dst,
+                                        void const* src) {
+  switch (v->_element_size) {
+  case 1:
+    memcpy(dst, src, 1);
+    break;
+  case 2:
+    memcpy(dst, src, 2);
+    break;
+  case 4:
+    memcpy(dst, src, 4);
+    break;
+  case 8:
+    memcpy(dst, src, 8);
+    break;
+  case 16:
+    memcpy(dst, src, 16);
+    break;
+  default:
+    v->_copy(dst, src, v->_element_size);
+    break;
+  }
+}
+
+/** Exchange two distinct elements, inline for the sizes of
+ * `_vector_copy_element` and through `_swap` otherwise */
+static inline void _vector_swap_elements(vector const* v, void* a, void* b) {
+  unsigned char tmp[16];
+  switch (v->_element_size) {
+  case 1:
+    memcpy(tmp, a, 1), memcpy(a, b, 1), memcpy(b, tmp, 1);
+    break;
+  case 2:
+    memcpy(tmp, a, 2), memcpy(a, b, 2), memcpy(b, tmp, 2);
+    break;
+  case 4:
+    memcpy(tmp, a, 4), memcpy(a, b, 4), memcpy(b, tmp, 4);
+    break;
+  case 8:
+    memcpy(tmp, a, 8), memcpy(a, b, 8), memcpy(b, tmp, 8);
+    break;
+  case 16:
+    memcpy(tmp, a, 16), memcpy(a, b, 16), memcpy(b, tmp, 16);
+    break;
+  default:
+    v->_swap(a, b, v->_element_size);
+    break;
+  }
+}
+
 #endif
@@ -0,0 +1,190 @@
+#include "vector_io.h"
+#include "vector_mmap.h"
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#define VECTOR_IO_MAGIC "GALVECT"
+
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t reserved;
+  uint64_t element_size;
+  uint64_t size;
+} vector_io_header;
+
+_Static_assert(sizeof(vector_io_header) == VECTOR_IO_HEADER_SIZE,
+               "vector_io_header has unexpected padding");
+
+static int vector_io_header_valid(vector_io_header const* h) {
+  if (memcmp(h->magic, VECTOR_IO_MAGIC, sizeof(h->magic)) != 0)
+    return 0;
+  if (h->version != VECTOR_IO_VERSION || h->element_size == 0)
+    return 0;
+  return h->size <= SIZE_MAX / h->element_size;
+}
+
+/* Reads exactly `length` bytes, failing with EINVAL on a premature end */
+static int vector_io_read_full(int fd, void* buf, size_t length) {
+  char* p = buf;
+  while (length > 0) {
+    ssize_t n = read(fd, p, length);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n < 0)
+      return -1;
+    if (n == 0) {
+      errno = EINVAL;
+      return -1;
+    }
+    p += n;
+    length -= (size_t)n;
+  }
+  return 0;
+}
+
+int vector_write(vector* v, int fd) {
+  vector_io_header h;
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, VECTOR_IO_MAGIC, sizeof(h.magic));
+  h.version = VECTOR_IO_VERSION;
+  h.element_size = v->_element_size;
+  h.size = v->_size;
+
+  struct iovec iov[2] = {
+      {&h, sizeof(h)},
+      {v->_data, v->_size * v->_element_size},
+  };
+  struct iovec* cur = iov;
+  int count = iov[1].iov_len > 0 ? 2 : 1;
+
+  while (count > 0) {
+    ssize_t n = writev(fd, cur, count);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n < 0)
+      return -1;
+
+    size_t written = (size_t)n;
+    while (count > 0 && written >= cur->iov_len) {
+      written -= cur->iov_len;
+      ++cur;
+      --count;
+    }
+    if (count > 0) {
+      cur->iov_base = (char*)cur->iov_base + written;
+      cur->iov_len -= written;
+    }
+  }
+
+  return 0;
+}
+
+vector* vector_read(int fd) {
+  vector_io_header h;
+  if (vector_io_read_full(fd, &h, sizeof(h)) != 0)
+    return NULL;
+  if (!vector_io_header_valid(&h)) {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  vector* v = vector_init(h.element_size);
+  if (!v)
+    return NULL;
+  if (vector_try_reserve(v, h.size) != 0) {
+    vector_deinit(v);
+    errno = ENOMEM;
+    return NULL;
+  }
+
+  if (vector_io_read_full(fd, v->_data, h.size * h.element_size) != 0) {
+    int saved = errno;
+    vector_deinit(v);
+    errno = saved;
+    return NULL;
+  }
+  v->_size = h.size;
+
+  return v;
+}
+
+vector* vector_read_mmap(int fd) {
+  struct stat st;
+  if (fstat(fd, &st) != 0)
+    return NULL;
+
+  off_t offset = lseek(fd, 0, SEEK_CUR);
+  if (offset < 0)
+    return NULL;
+
+  vector_io_header h;
+  if (vector_io_read_full(fd, &h, sizeof(h)) != 0)
+    return NULL;
+  if (!vector_io_header_valid(&h)) {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  size_t data_size = h.size * h.element_size;
+  size_t end = (size_t)offset + sizeof(h) + data_size;
+  if (end > (size_t)st.st_size) {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  /* mmap offsets must be page aligned, so map from the page holding the
+   * header and skip to the elements */
+  size_t page = (size_t)sysconf(_SC_PAGESIZE);
+  size_t map_offset = (size_t)offset / page * page;
+  size_t length = end - map_offset;
+
+  vector* v = malloc(sizeof(vector));
+  struct vector_mapping* m = malloc(sizeof(struct vector_mapping));
+  if (!v || !m) {
+    free(v);
+    free(m);
+    errno = ENOMEM;
+    return NULL;
+  }
+
+  void* base = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, (off_t)map_offset);
+  if (base == MAP_FAILED) {
+    free(v);
+    free(m);
+    return NULL;
+  }
+
+  if (lseek(fd, (off_t)end, SEEK_SET) < 0) {
+    int saved = errno;
+    munmap(base, length);
+    free(v);
+    free(m);
+    errno = saved;
+    return NULL;
+  }
+
+  m->fd = -1;
+  m->base = base;
+  m->length = length;
+
+  v->_element_size = h.element_size;
+  v->_size = h.size;
+  v->_capacity = h.size;
+  v->_max_capacity = VECTOR_MAX_SIZE;
+  v->_allocator = gal_std_allocator;
+  _vector_init_kernels(v);
+#ifdef GAL_ALLOC_STATS
+  memset(&v->_stats, 0, sizeof(v->_stats));
+#endif
+  v->_data = (char*)base + ((size_t)offset - map_offset) + sizeof(h);
+  v->_mapping = m;
+
+  return v;
+}
@@ -0,0 +1,57 @@
+/** vector_io.h - binary serialization of vectors */
+
+#ifndef GAL_VECTOR_IO_H
+#define GAL_VECTOR_IO_H
+
+#include <stddef.h>
+
+#include "vector.h"
+
+/** Version of the serialization format written by `vector_write` */
+#define VECTOR_IO_VERSION 1
+
+/** Size of the header that precedes the elements */
+#define VECTOR_IO_HEADER_SIZE 32
+
+/** Write a vector to a file descriptor
+ *
+ * Writes a header (magic, format version, element size and element count, in
+ * native byte order) followed by the raw element block, starting at the
+ * current file offset. Both parts are passed to a single `writev`, which is
+ * repeated only if the kernel accepts a partial write.
+ *
+ * Returns 0 on success and -1 with errno set on failure.
+ *
+ * Complexity: O(n)
+ */
+int vector_write(vector* v, int fd);
+
+/** Read a vector from a file descriptor
+ *
+ * Reads a vector written by `vector_write` from the current file offset. The
+ * vector is allocated with its final capacity up front and the elements are
+ * read straight into it.
+ *
+ * Returns NULL with errno set on failure, EINVAL if the data is not a
+ * serialized vector or has an unsupported version.
+ *
+ * Complexity: O(n)
+ */
+vector* vector_read(int fd);
+
+/** Map a serialized vector without copying it
+ *
+ * Maps the vector written by `vector_write` at the current offset of a
+ * regular file. The returned vector is read-only: its elements are the pages
+ * of a read-only mapping, so they must not be written. Resizing it fails
+ * with EROFS, which makes the `vector_try_` functions return -1 and the
+ * other growing operations terminate the program. `vector_deinit` unmaps
+ * it. The file descriptor may be closed right after the call.
+ *
+ * Returns NULL with errno set on failure, EINVAL as for `vector_read`.
+ *
+ * Complexity: O(1)
+ */
+vector* vector_read_mmap(int fd);
+
+#endif
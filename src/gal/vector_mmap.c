@@ -0,0 +1,209 @@
+#define _GNU_SOURCE
+
+#include "vector_mmap.h"
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define VECTOR_MMAP_MAGIC "GALVMAP1"
+#define VECTOR_MMAP_INITIAL_CAPACITY 16
+
+typedef struct {
+  char magic[8];
+  uint64_t element_size;
+  uint64_t size;
+  uint64_t capacity;
+  uint64_t checksum;
+} vector_mmap_header;
+
+_Static_assert(sizeof(vector_mmap_header) <= VECTOR_MMAP_HEADER_SIZE,
+               "vector_mmap_header does not fit");
+
+static uint64_t vector_mmap_checksum(vector_mmap_header const* h) {
+  uint64_t fields[3] = {h->element_size, h->size, h->capacity};
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (size_t i = 0; i < 3; ++i) {
+    hash ^= fields[i];
+    hash *= 0x100000001b3ull;
+    hash ^= hash >> 29;
+  }
+  return hash;
+}
+
+static vector_mmap_header* vector_mmap_header_of(vector* v) {
+  return (vector_mmap_header*)v->_mapping->base;
+}
+
+static void vector_mmap_store_header(vector* v) {
+  vector_mmap_header* h = vector_mmap_header_of(v);
+  h->element_size = v->_element_size;
+  h->size = v->_size;
+  h->capacity = v->_capacity;
+  h->checksum = vector_mmap_checksum(h);
+}
+
+static size_t vector_mmap_length(size_t element_size, size_t capacity) {
+  return VECTOR_MMAP_HEADER_SIZE + element_size * capacity;
+}
+
+static int vector_mmap_header_valid(vector_mmap_header const* h,
+                                    size_t element_size, size_t file_size) {
+  if (memcmp(h->magic, VECTOR_MMAP_MAGIC, sizeof(h->magic)) != 0)
+    return 0;
+  if (h->checksum != vector_mmap_checksum(h))
+    return 0;
+  if (h->element_size != element_size || h->size > h->capacity)
+    return 0;
+  return file_size >= vector_mmap_length(element_size, h->capacity);
+}
+
+vector* vector_open_mmap(char const* path, size_t element_size) {
+  assert(element_size > 0 && "vector_open_mmap");
+
+  vector* v = malloc(sizeof(vector));
+  struct vector_mapping* m = malloc(sizeof(struct vector_mapping));
+  if (!v || !m) {
+    free(v);
+    free(m);
+    errno = ENOMEM;
+    return NULL;
+  }
+
+  int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0)
+    goto fail;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0)
+    goto fail_close;
+
+  int created = st.st_size == 0;
+  size_t length;
+  if (created) {
+    length = vector_mmap_length(element_size, VECTOR_MMAP_INITIAL_CAPACITY);
+    if (ftruncate(fd, (off_t)length) != 0)
+      goto fail_close;
+  } else if ((size_t)st.st_size < VECTOR_MMAP_HEADER_SIZE) {
+    errno = EINVAL;
+    goto fail_close;
+  } else {
+    length = (size_t)st.st_size;
+  }
+
+  void* base = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (base == MAP_FAILED)
+    goto fail_close;
+
+  vector_mmap_header* h = base;
+  if (created) {
+    memcpy(h->magic, VECTOR_MMAP_MAGIC, sizeof(h->magic));
+    h->element_size = element_size;
+    h->size = 0;
+    h->capacity = VECTOR_MMAP_INITIAL_CAPACITY;
+    h->checksum = vector_mmap_checksum(h);
+  } else if (!vector_mmap_header_valid(h, element_size, length)) {
+    munmap(base, length);
+    errno = EINVAL;
+    goto fail_close;
+  }
+
+  m->fd = fd;
+  m->base = base;
+  m->length = length;
+
+  v->_element_size = element_size;
+  v->_size = h->size;
+  v->_capacity = h->capacity;
+  v->_max_capacity = VECTOR_MAX_SIZE;
+  v->_allocator = gal_std_allocator;
+  _vector_init_kernels(v);
+#ifdef GAL_ALLOC_STATS
+  memset(&v->_stats, 0, sizeof(v->_stats));
+#endif
+  v->_data = (char*)base + VECTOR_MMAP_HEADER_SIZE;
+  v->_mapping = m;
+
+  return v;
+
+fail_close:;
+  int saved = errno;
+  close(fd);
+  errno = saved;
+fail:
+  free(v);
+  free(m);
+  return NULL;
+}
+
+int vector_sync(vector* v) {
+  assert(v->_mapping && v->_mapping->fd >= 0 && "vector_sync");
+
+  vector_mmap_store_header(v);
+  return msync(v->_mapping->base, v->_mapping->length, MS_SYNC);
+}
+
+int _vector_mmap_resize(vector* v, size_t capacity) {
+  struct vector_mapping* m = v->_mapping;
+  if (m->fd < 0) {
+    errno = EROFS;
+    return -1;
+  }
+  size_t length = vector_mmap_length(v->_element_size, capacity);
+  void* base;
+
+  /* The file has to cover the new mapping before pages past the old end are
+   * touched, and must be shrunk only after the mapping is. */
+  if (length > m->length && ftruncate(m->fd, (off_t)length) != 0)
+    return -1;
+
+#ifdef MREMAP_MAYMOVE
+  base = mremap(m->base, m->length, length, MREMAP_MAYMOVE);
+#else
+  base = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, m->fd, 0);
+  if (base != MAP_FAILED)
+    munmap(m->base, m->length);
+#endif
+  /* A file that stays larger than the mapping is harmless, so failures to
+   * shrink it are ignored */
+  if (base == MAP_FAILED) {
+    int saved = errno;
+    if (length > m->length) {
+      int rc = ftruncate(m->fd, (off_t)m->length);
+      (void)rc;
+    }
+    errno = saved;
+    return -1;
+  }
+
+  if (length < m->length) {
+    int rc = ftruncate(m->fd, (off_t)length);
+    (void)rc;
+  }
+
+  m->base = base;
+  m->length = length;
+  v->_data = (char*)base + VECTOR_MMAP_HEADER_SIZE;
+  v->_capacity = capacity;
+  vector_mmap_store_header(v);
+  return 0;
+}
+
+void _vector_mmap_close(vector* v) {
+  struct vector_mapping* m = v->_mapping;
+
+  if (m->fd >= 0) {
+    vector_mmap_store_header(v);
+    close(m->fd);
+  }
+  munmap(m->base, m->length);
+  free(m);
+
+  v->_mapping = NULL;
+  v->_data = NULL;
+}
@@ -0,0 +1,78 @@
+/** vector_mmap.h - vector persisted in a memory-mapped file */
+
+#ifndef GAL_VECTOR_MMAP_H
+#define GAL_VECTOR_MMAP_H
+
+#include <stddef.h>
+
+#include "vector.h"
+
+/** Size of the file header that precedes the elements */
+#define VECTOR_MMAP_HEADER_SIZE 64
+
+/** Mapping that holds the elements of a vector
+ *
+ * @field fd
+ * Descriptor of the backing file, or -1 for a read-only view
+ *
+ * @field base
+ * Start of the mapping
+ *
+ * @field length
+ * Length of the mapping
+ */
+struct vector_mapping {
+  int fd;
+  void* base;
+  size_t length;
+};
+
+/** Open a vector stored in a file
+ *
+ * The elements live in a shared mapping of the file, right after a header
+ * that records element size, size and capacity along with a checksum of
+ * these fields. If the file does not exist or is empty, an empty vector is
+ * created in it. Otherwise the stored elements are available immediately,
+ * without reading the file, and the page cache is shared with every other
+ * process that maps it.
+ *
+ * The returned vector supports all vector operations. Growing it extends the
+ * file with `ftruncate` and the mapping with `mremap`; `vector_deinit`
+ * unmaps and closes the file.
+ *
+ * Returns NULL and sets errno if the file can not be opened or mapped, or
+ * EINVAL if its header is corrupted or its element size differs from
+ * `element_size`.
+ */
+vector* vector_open_mmap(char const* path, size_t element_size);
+
+/** Flush a file-backed vector to disk
+ *
+ * Stores the current size in the header and waits until all modified pages
+ * are written back with `msync`. Without this call, changes reach the file at
+ * the discretion of the kernel, and the stored size is updated only when the
+ * vector is resized or closed.
+ *
+ * Returns 0 on success and -1 with errno set on failure.
+ */
+int vector_sync(vector* v);
+
+/** Resize the file and the mapping of a file-backed vector
+ *
+ * Returns 0 on success and -1 with errno set on failure, in which case the
+ * vector is left unchanged. A read-only view can not be resized and fails
+ * with EROFS.
+ *
+ * Used by `vector_try_resize`.
+ */
+int _vector_mmap_resize(vector* v, size_t capacity);
+
+/** Unmap a vector's mapping
+ *
+ * A file-backed vector gets its header stored and its file closed first.
+ *
+ * Used by `vector_deinit`.
+ */
+void _vector_mmap_close(vector* v);
+
+#endif
@@ -0,0 +1,255 @@
+#include "vector_set.h"
+#include <assert.h>
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/* Makes room for n more elements in out, the only allocation of an
+ * operation */
+static int vector_set_reserve(vector* out, vector* a, vector* b, size_t n) {
+  assert(out->_element_size == a->_element_size &&
+         out->_element_size == b->_element_size && "vector_set");
+  assert(out != a && out != b && "vector_set");
+  (void)a;
+  (void)b;
+
+  if (n > SIZE_MAX - out->_size) {
+    errno = ENOMEM;
+    return -1;
+  }
+  return vector_try_reserve(out, out->_size + n);
+}
+
+/* Appends within the reserved capacity */
+static void vector_set_put(vector* out, void const* e) {
+  _vector_copy_element(out, vector_end(out), e);
+  out->_size += 1;
+}
+
+static void vector_set_put_n(vector* out, vector* v, size_t from, size_t to) {
+  if (from < to) {
+    memcpy(vector_end(out), vector_at_unchecked(v, from),
+           (to - from) * out->_element_size);
+    out->_size += to - from;
+  }
+}
+
+/* First index in [lo, size) whose element is not less than the key: probes
+ * lo, lo + 1, lo + 3, lo + 7, ... and then bisects the last gap */
+static size_t vector_set_gallop(vector* v, size_t lo, void const* key,
+                                int (*cmp)(void const*, void const*)) {
+  size_t n = v->_size;
+  size_t hi = lo;
+  for (size_t step = 1; hi < n && cmp(vector_at_unchecked(v, hi), key) < 0;
+       step *= 2) {
+    lo = hi + 1;
+    hi = step > n - hi ? n : hi + step;
+  }
+
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (cmp(vector_at_unchecked(v, mid), key) < 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+static int vector_set_asymmetric(size_t small, size_t large) {
+  return small <= large / VECTOR_SET_GALLOP_RATIO;
+}
+
+int vector_set_merge(vector* out, vector* a, vector* b,
+                     int (*cmp)(void const*, void const*)) {
+  size_t m = a->_size, n = b->_size;
+  if (vector_set_reserve(out, a, b, m + n) != 0)
+    return -1;
+
+  size_t i = 0, j = 0;
+  while (i < m && j < n) {
+    void* x = vector_at_unchecked(a, i);
+    void* y = vector_at_unchecked(b, j);
+    if (cmp(y, x) < 0) {
+      vector_set_put(out, y);
+      ++j;
+    } else {
+      vector_set_put(out, x);
+      ++i;
+    }
+  }
+  vector_set_put_n(out, a, i, m);
+  vector_set_put_n(out, b, j, n);
+  return 0;
+}
+
+int vector_set_union(vector* out, vector* a, vector* b,
+                     int (*cmp)(void const*, void const*)) {
+  size_t m = a->_size, n = b->_size;
+  if (vector_set_reserve(out, a, b, m + n) != 0)
+    return -1;
+
+  size_t i = 0, j = 0;
+  while (i < m && j < n) {
+    void* x = vector_at_unchecked(a, i);
+    void* y = vector_at_unchecked(b, j);
+    int c = cmp(x, y);
+    if (c > 0) {
+      vector_set_put(out, y);
+      ++j;
+    } else {
+      vector_set_put(out, x);
+      ++i;
+      j += c == 0;
+    }
+  }
+  vector_set_put_n(out, a, i, m);
+  vector_set_put_n(out, b, j, n);
+  return 0;
+}
+
+int vector_set_intersection(vector* out, vector* a, vector* b,
+                            int (*cmp)(void const*, void const*)) {
+  size_t m = a->_size, n = b->_size;
+  if (vector_set_reserve(out, a, b, m < n ? m : n) != 0)
+    return -1;
+
+  size_t i = 0, j = 0;
+  if (vector_set_asymmetric(m, n)) {
+    for (; i < m; ++i) {
+      void* x = vector_at_unchecked(a, i);
+      j = vector_set_gallop(b, j, x, cmp);
+      if (j == n)
+        break;
+      if (cmp(vector_at_unchecked(b, j), x) == 0) {
+        vector_set_put(out, x);
+        ++j;
+      }
+    }
+  } else if (vector_set_asymmetric(n, m)) {
+    for (; j < n; ++j) {
+      void* y = vector_at_unchecked(b, j);
+      i = vector_set_gallop(a, i, y, cmp);
+      if (i == m)
+        break;
+      if (cmp(vector_at_unchecked(a, i), y) == 0) {
+        vector_set_put(out, vector_at_unchecked(a, i));
+        ++i;
+      }
+    }
+  } else {
+    while (i < m && j < n) {
+      void* x = vector_at_unchecked(a, i);
+      int c = cmp(x, vector_at_unchecked(b, j));
+      if (c == 0)
+        vector_set_put(out, x);
+      i += c <= 0;
+      j += c >= 0;
+    }
+  }
+  return 0;
+}
+
+int vector_set_difference(vector* out, vector* a, vector* b,
+                          int (*cmp)(void const*, void const*)) {
+  size_t m = a->_size, n = b->_size;
+  if (vector_set_reserve(out, a, b, m) != 0)
+    return -1;
+
+  size_t i = 0, j = 0;
+  if (vector_set_asymmetric(m, n)) {
+    for (; i < m && j < n; ++i) {
+      void* x = vector_at_unchecked(a, i);
+      j = vector_set_gallop(b, j, x, cmp);
+      if (j < n && cmp(vector_at_unchecked(b, j), x) == 0)
+        ++j;
+      else
+        vector_set_put(out, x);
+    }
+  } else if (vector_set_asymmetric(n, m)) {
+    /* Copies the runs of `a` between the elements of `b` in one go */
+    for (; j < n && i < m; ++j) {
+      void* y = vector_at_unchecked(b, j);
+      size_t k = vector_set_gallop(a, i, y, cmp);
+      vector_set_put_n(out, a, i, k);
+      i = k;
+      if (i < m && cmp(vector_at_unchecked(a, i), y) == 0)
+        ++i;
+    }
+  } else {
+    while (i < m && j < n) {
+      void* x = vector_at_unchecked(a, i);
+      int c = cmp(x, vector_at_unchecked(b, j));
+      if (c < 0)
+        vector_set_put(out, x);
+      i += c <= 0;
+      j += c >= 0;
+    }
+  }
+  vector_set_put_n(out, a, i, m);
+  return 0;
+}
+
+static int vector_set_cmp_u32(void const* a, void const* b) {
+  uint32_t x = *(uint32_t const*)a, y = *(uint32_t const*)b;
+  return (x > y) - (x < y);
+}
+
+/* Intersects blocks of four: every element of the `a` block is compared
+ * with all four rotations of the `b` block, and the block with the smaller
+ * last element moves on */
+static size_t vector_set_intersect_u32(uint32_t const* a, size_t m,
+                                       uint32_t const* b, size_t n,
+                                       uint32_t* out) {
+  size_t i = 0, j = 0, k = 0;
+
+#ifdef __SSE2__
+  while (i + 4 <= m && j + 4 <= n) {
+    __m128i va = _mm_loadu_si128((__m128i const*)(a + i));
+    __m128i vb = _mm_loadu_si128((__m128i const*)(b + j));
+    __m128i vb1 = _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1));
+    __m128i vb2 = _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2));
+    __m128i vb3 = _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3));
+    __m128i eq = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi32(va, vb), _mm_cmpeq_epi32(va, vb1)),
+        _mm_or_si128(_mm_cmpeq_epi32(va, vb2), _mm_cmpeq_epi32(va, vb3)));
+
+    unsigned mask = (unsigned)_mm_movemask_ps(_mm_castsi128_ps(eq));
+    for (; mask; mask &= mask - 1) {
+      out[k++] = a[i + (size_t)__builtin_ctz(mask)];
+    }
+
+    uint32_t a_last = a[i + 3], b_last = b[j + 3];
+    i += a_last <= b_last ? 4 : 0;
+    j += b_last <= a_last ? 4 : 0;
+  }
+#endif
+
+  while (i < m && j < n) {
+    if (a[i] == b[j])
+      out[k++] = a[i];
+    uint32_t x = a[i], y = b[j];
+    i += x <= y;
+    j += y <= x;
+  }
+  return k;
+}
+
+int vector_set_intersection_u32(vector* out, vector* a, vector* b) {
+  assert(a->_element_size == sizeof(uint32_t) &&
+         "vector_set_intersection_u32");
+
+  size_t m = a->_size, n = b->_size;
+  if (vector_set_asymmetric(m, n) || vector_set_asymmetric(n, m))
+    return vector_set_intersection(out, a, b, vector_set_cmp_u32);
+
+  if (vector_set_reserve(out, a, b, m < n ? m : n) != 0)
+    return -1;
+  out->_size += vector_set_intersect_u32(vector_data(a), m, vector_data(b), n,
+                                         vector_end(out));
+  return 0;
+}
@@ -0,0 +1,74 @@
+/** vector_set.h - set operations over sorted vectors */
+
+#ifndef GAL_VECTOR_SET_H
+#define GAL_VECTOR_SET_H
+
+#include "vector.h"
+
+/** Size ratio above which the operations gallop through the larger input
+ *
+ * Each element of the smaller input is then located in the larger one by
+ * exponential search, so an intersection costs O(m log(n / m)) comparisons
+ * instead of O(m + n).
+ */
+#define VECTOR_SET_GALLOP_RATIO 32
+
+/* All operations take inputs sorted by the comparison function, which has
+ * the same contract as for `vector_quicksort`, and append the result to
+ * `out`. `out` must have the element size of the inputs and be distinct from
+ * both. Its capacity is reserved once for the largest possible result before
+ * anything is written.
+ *
+ * Equal elements are matched pairwise as in a multiset: an element occurring
+ * m times in `a` and n times in `b` occurs max(m, n) times in a union,
+ * min(m, n) times in an intersection and max(m - n, 0) times in a
+ * difference. Elements are copied from `a` where both inputs have them.
+ *
+ * All return 0 on success and -1 with errno set to ENOMEM if the capacity
+ * can not be reserved, in which case `out` is left unchanged.
+ */
+
+/** Merge two sorted vectors, keeping every element of both
+ *
+ * Stable: of equal elements, those from `a` come first.
+ *
+ * Complexity: O(m + n)
+ */
+int vector_set_merge(vector* out, vector* a, vector* b,
+                     int (*cmp)(void const*, void const*));
+
+/** Elements that are in `a` or in `b`
+ *
+ * Complexity: O(m + n)
+ */
+int vector_set_union(vector* out, vector* a, vector* b,
+                     int (*cmp)(void const*, void const*));
+
+/** Elements that are in both `a` and `b`
+ *
+ * Complexity: O(m + n), or O(m log(n / m)) if one input is at least
+ * VECTOR_SET_GALLOP_RATIO times larger
+ */
+int vector_set_intersection(vector* out, vector* a, vector* b,
+                            int (*cmp)(void const*, void const*));
+
+/** Elements of `a` that are not in `b`
+ *
+ * Complexity: O(m + n), or O(m log(n / m)) if `b` is at least
+ * VECTOR_SET_GALLOP_RATIO times larger than `a`
+ */
+int vector_set_difference(vector* out, vector* a, vector* b,
+                          int (*cmp)(void const*, void const*));
+
+/** Intersect two vectors of strictly increasing `uint32_t`
+ *
+ * Compares blocks of four elements of each input at once with SSE2 where it
+ * is available, and falls back to a scalar merge otherwise. Gallops like
+ * `vector_set_intersection` for asymmetric sizes.
+ *
+ * Complexity: O(m + n), or O(m log(n / m)) if one input is at least
+ * VECTOR_SET_GALLOP_RATIO times larger
+ */
+int vector_set_intersection_u32(vector* out, vector* a, vector* b);
+
+#endif
@@ -0,0 +1,169 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <check.h>
+#include <gal/allocator.h>
+#include <gal/vector.h>
+
+/********************************* TESTS *************************************/
+
+#define MIB ((size_t)1024 * 1024)
+
+static void fill(uint8_t* p, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    p[i] = (uint8_t)(i * 7);
+  }
+}
+
+static int check_fill(uint8_t const* p, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    if (p[i] != (uint8_t)(i * 7))
+      return 0;
+  }
+  return 1;
+}
+
+START_TEST(test_large_allocator_grow_and_shrink) {
+  uint8_t* p = gal_large_allocator(NULL, 0, 3 * MIB);
+  ck_assert_ptr_nonnull(p);
+  fill(p, 3 * MIB);
+
+  p = gal_large_allocator(p, 3 * MIB, 9 * MIB);
+  ck_assert_ptr_nonnull(p);
+  ck_assert(check_fill(p, 3 * MIB));
+
+  p = gal_large_allocator(p, 9 * MIB, 4096);
+  ck_assert_ptr_nonnull(p);
+  ck_assert(check_fill(p, 4096));
+
+  ck_assert_ptr_null(gal_large_allocator(p, 4096, 0));
+}
+END_TEST
+
+START_TEST(test_large_allocator_falls_back_without_hugetlb) {
+  gal_large_alloc_config config = {GAL_HUGE_PAGES_HUGETLB,
+                                    GAL_NUMA_INTERLEAVE, 1};
+  gal_large_allocator_configure(&config);
+
+  uint8_t* p = gal_large_allocator(NULL, 0, 4 * MIB);
+  ck_assert_ptr_nonnull(p);
+  fill(p, 4 * MIB);
+  p = gal_large_allocator(p, 4 * MIB, 5 * MIB);
+  ck_assert(check_fill(p, 4 * MIB));
+  gal_large_allocator(p, 5 * MIB, 0);
+
+  gal_large_alloc_config defaults = {GAL_HUGE_PAGES_TRANSPARENT,
+                                     GAL_NUMA_DEFAULT, 0};
+  gal_large_allocator_configure(&defaults);
+}
+END_TEST
+
+START_TEST(test_tiered_allocator_crosses_threshold) {
+  size_t small = GAL_LARGE_ALLOC_THRESHOLD / 2;
+  size_t large = GAL_LARGE_ALLOC_THRESHOLD * 2;
+
+  uint8_t* p = gal_tiered_allocator(NULL, 0, small);
+  fill(p, small);
+
+  p = gal_tiered_allocator(p, small, large);
+  ck_assert_ptr_nonnull(p);
+  ck_assert(check_fill(p, small));
+  fill(p, large);
+
+  p = gal_tiered_allocator(p, large, small);
+  ck_assert_ptr_nonnull(p);
+  ck_assert(check_fill(p, small));
+
+  gal_tiered_allocator(p, small, 0);
+}
+END_TEST
+
+START_TEST(test_vector_with_tiered_allocator) {
+  vector* v = vector_init_with_allocator(4, gal_tiered_allocator);
+
+  for (int32_t i = 0; i < 1000000; ++i) {
+    vector_push(v, &i);
+  }
+
+  ck_assert_uint_ge(vector_capacity(v) * 4, GAL_LARGE_ALLOC_THRESHOLD);
+  for (int32_t i = 0; i < 1000000; i += 997) {
+    ck_assert_int_eq(*(int32_t*)vector_at(v, i), i);
+  }
+
+  vector_deinit(v);
+}
+END_TEST
+
+START_TEST(test_stats_allocate_counts_calls) {
+  gal_alloc_stats stats;
+  memset(&stats, 0, sizeof(stats));
+
+  void* p = gal_stats_allocate(&stats, gal_std_allocator, NULL, 0, 100);
+  p = gal_stats_allocate(&stats, gal_std_allocator, p, 100, 300);
+  p = gal_stats_allocate(&stats, gal_std_allocator, p, 300, 200);
+
+  ck_assert_uint_eq(stats.allocs, 1);
+  ck_assert_uint_eq(stats.reallocs, 2);
+  ck_assert_uint_eq(stats.bytes_live, 200);
+  ck_assert_uint_eq(stats.bytes_peak, 300);
+  ck_assert_uint_eq(stats.histogram[6], 1);
+  ck_assert_uint_eq(stats.histogram[7], 1);
+  ck_assert_uint_eq(stats.histogram[8], 1);
+
+  gal_stats_allocate(&stats, gal_std_allocator, p, 200, 0);
+
+  ck_assert_uint_eq(stats.frees, 1);
+  ck_assert_uint_eq(stats.bytes_live, 0);
+  ck_assert_uint_eq(stats.bytes_peak, 300);
+}
+END_TEST
+
+START_TEST(test_vector_alloc_stats) {
+  vector* v = vector_init(4);
+
+#ifdef GAL_ALLOC_STATS
+  for (int32_t i = 0; i < 100; ++i) {
+    vector_push(v, &i);
+  }
+  free(vector_pop(v));
+
+  gal_alloc_stats const* stats = vector_alloc_stats(v);
+  ck_assert_uint_eq(stats->allocs, 1);
+  ck_assert_uint_eq(stats->reallocs, 3);
+  ck_assert_uint_eq(stats->bytes_live, 128 * 4);
+  ck_assert_uint_eq(stats->copy_allocs, 1);
+  ck_assert_uint_eq(stats->copy_bytes, 4);
+#else
+  ck_assert_ptr_null(vector_alloc_stats(v));
+#endif
+
+  vector_deinit(v);
+}
+END_TEST
+
+/******************************* END TESTS ***********************************/
+
+Suite* allocator_test_suite(void) {
+  Suite* s = suite_create("allocator");
+  TCase* tc_core = tcase_create("core");
+
+  tcase_add_test(tc_core, test_large_allocator_grow_and_shrink);
+  tcase_add_test(tc_core, test_large_allocator_falls_back_without_hugetlb);
+  tcase_add_test(tc_core, test_tiered_allocator_crosses_threshold);
+  tcase_add_test(tc_core, test_vector_with_tiered_allocator);
+  tcase_add_test(tc_core, test_stats_allocate_counts_calls);
+  tcase_add_test(tc_core, test_vector_alloc_stats);
+
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+int main(void) {
+  Suite* s = allocator_test_suite();
+  SRunner* sr = srunner_create(s);
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,207 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <check.h>
+#include <gal/bitset.h>
+#include <gal/vector.h>
+
+/********************************* TESTS *************************************/
+
+static int is_multiple_of_3(void const* e) {
+  return *(int32_t const*)e % 3 == 0;
+}
+
+START_TEST(test_bitset_create_and_delete) {
+  bitset* bs = bitset_init(100);
+  ck_assert_uint_eq(bitset_size(bs), 100);
+  ck_assert_uint_eq(bitset_count(bs), 0);
+  ck_assert_uint_eq(bitset_find_next(bs, 0), BITSET_NPOS);
+  bitset_deinit(bs);
+
+  bs = bitset_init(0);
+  ck_assert_uint_eq(bitset_rank(bs, 0), 0);
+  ck_assert_uint_eq(bitset_select(bs, 0), BITSET_NPOS);
+  bitset_deinit(bs);
+}
+END_TEST
+
+START_TEST(test_set_test_clear) {
+  bitset* bs = bitset_init(130);
+
+  bitset_set(bs, 0);
+  bitset_set(bs, 63);
+  bitset_set(bs, 64);
+  bitset_set(bs, 129);
+  ck_assert_int_eq(bitset_test(bs, 0), 1);
+  ck_assert_int_eq(bitset_test(bs, 1), 0);
+  ck_assert_int_eq(bitset_test(bs, 63), 1);
+  ck_assert_int_eq(bitset_test(bs, 64), 1);
+  ck_assert_int_eq(bitset_test(bs, 129), 1);
+  ck_assert_uint_eq(bitset_count(bs), 4);
+
+  bitset_clear(bs, 63);
+  ck_assert_int_eq(bitset_test(bs, 63), 0);
+  ck_assert_uint_eq(bitset_count(bs), 3);
+
+  bitset_set_all(bs);
+  ck_assert_uint_eq(bitset_count(bs), 130);
+  bitset_flip_all(bs);
+  ck_assert_uint_eq(bitset_count(bs), 0);
+  bitset_flip_all(bs);
+  ck_assert_uint_eq(bitset_count(bs), 130);
+  bitset_clear_all(bs);
+  ck_assert_uint_eq(bitset_count(bs), 0);
+
+  bitset_deinit(bs);
+}
+END_TEST
+
+START_TEST(test_find_next) {
+  bitset* bs = bitset_init(1000);
+  size_t positions[] = {3, 64, 65, 500, 999};
+  for (size_t i = 0; i < 5; ++i) {
+    bitset_set(bs, positions[i]);
+  }
+
+  size_t found = 0;
+  for (size_t i = bitset_find_next(bs, 0); i != BITSET_NPOS;
+       i = bitset_find_next(bs, i + 1)) {
+    ck_assert_uint_eq(i, positions[found]);
+    found += 1;
+  }
+  ck_assert_uint_eq(found, 5);
+  ck_assert_uint_eq(bitset_find_next(bs, 66), 500);
+  ck_assert_uint_eq(bitset_find_next(bs, 1000), BITSET_NPOS);
+
+  bitset_deinit(bs);
+}
+END_TEST
+
+START_TEST(test_rank_select) {
+  size_t size = 5000;
+  bitset* bs = bitset_init(size);
+  uint64_t x = 88172645463325252ull;
+  for (size_t i = 0; i < size; ++i) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    if (x % 5 == 0)
+      bitset_set(bs, i);
+  }
+
+  size_t count = 0;
+  for (size_t i = 0; i < size; ++i) {
+    ck_assert_uint_eq(bitset_rank(bs, i), count);
+    if (bitset_test(bs, i)) {
+      ck_assert_uint_eq(bitset_select(bs, count), i);
+      count += 1;
+    }
+  }
+  ck_assert_uint_eq(bitset_rank(bs, size), count);
+  ck_assert_uint_eq(bitset_count(bs), count);
+  ck_assert_uint_eq(bitset_select(bs, count), BITSET_NPOS);
+
+  /* an update invalidates the directory */
+  size_t free_bit = 0;
+  while (bitset_test(bs, free_bit)) {
+    free_bit += 1;
+  }
+  bitset_set(bs, free_bit);
+  ck_assert_uint_eq(bitset_rank(bs, size), count + 1);
+  ck_assert_uint_eq(bitset_rank(bs, free_bit + 1),
+                    bitset_rank(bs, free_bit) + 1);
+  ck_assert_uint_eq(bitset_select(bs, bitset_rank(bs, free_bit)), free_bit);
+
+  bitset_deinit(bs);
+}
+END_TEST
+
+START_TEST(test_bulk_operations) {
+  size_t size = 1000;
+  bitset* a = bitset_init(size);
+  bitset* b = bitset_init(size);
+  for (size_t i = 0; i < size; ++i) {
+    if (i % 2 == 0)
+      bitset_set(a, i);
+    if (i % 3 == 0)
+      bitset_set(b, i);
+  }
+
+  bitset* r = bitset_init(size);
+  bitset_or(r, a);
+  bitset_and(r, b);
+  for (size_t i = 0; i < size; ++i) {
+    ck_assert_int_eq(bitset_test(r, i), i % 6 == 0);
+  }
+
+  bitset_clear_all(r);
+  bitset_or(r, a);
+  bitset_or(r, b);
+  for (size_t i = 0; i < size; ++i) {
+    ck_assert_int_eq(bitset_test(r, i), i % 2 == 0 || i % 3 == 0);
+  }
+
+  bitset_clear_all(r);
+  bitset_or(r, a);
+  bitset_xor(r, b);
+  for (size_t i = 0; i < size; ++i) {
+    ck_assert_int_eq(bitset_test(r, i), (i % 2 == 0) != (i % 3 == 0));
+  }
+
+  bitset_clear_all(r);
+  bitset_or(r, a);
+  bitset_andnot(r, b);
+  for (size_t i = 0; i < size; ++i) {
+    ck_assert_int_eq(bitset_test(r, i), i % 2 == 0 && i % 3 != 0);
+  }
+  ck_assert_uint_eq(bitset_count(r), bitset_rank(r, size));
+
+  bitset_deinit(r);
+  bitset_deinit(b);
+  bitset_deinit(a);
+}
+END_TEST
+
+START_TEST(test_from_vector) {
+  vector* v = vector_init(4);
+  for (int32_t i = 0; i < 200; ++i) {
+    vector_push(v, &i);
+  }
+
+  bitset* bs = bitset_from_vector(v, is_multiple_of_3);
+  ck_assert_uint_eq(bitset_size(bs), 200);
+  ck_assert_uint_eq(bitset_count(bs), 67);
+  for (size_t i = 0; i < 200; ++i) {
+    ck_assert_int_eq(bitset_test(bs, i), i % 3 == 0);
+  }
+
+  bitset_deinit(bs);
+  vector_deinit(v);
+}
+END_TEST
+
+/******************************* END TESTS ***********************************/
+
+Suite* bitset_test_suite(void) {
+  Suite* s = suite_create("bitset");
+  TCase* tc_core = tcase_create("core");
+
+  tcase_add_test(tc_core, test_bitset_create_and_delete);
+  tcase_add_test(tc_core, test_set_test_clear);
+  tcase_add_test(tc_core, test_find_next);
+  tcase_add_test(tc_core, test_rank_select);
+  tcase_add_test(tc_core, test_bulk_operations);
+  tcase_add_test(tc_core, test_from_vector);
+
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+int main(void) {
+  Suite* s = bitset_test_suite();
+  SRunner* sr = srunner_create(s);
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,143 @@
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <check.h>
+#include <gal/clru_cache.h>
+
+/********************************* TESTS *************************************/
+
+#define THREADS 4
+#define OPS_PER_THREAD 50000
+#define KEYS 4096
+
+START_TEST(test_clru_cache_create_and_delete) {
+  clru_cache* c = clru_cache_init(4, 4, 100, 0);
+  ck_assert_ptr_nonnull(c);
+  ck_assert_uint_eq(clru_cache_size(c), 0);
+
+  int32_t key = 1, value;
+  ck_assert_int_eq(clru_cache_get(c, &key, &value), 0);
+  ck_assert_uint_eq(clru_cache_stats(c).misses, 1);
+  clru_cache_deinit(c);
+}
+END_TEST
+
+START_TEST(test_put_get_remove) {
+  clru_cache* c = clru_cache_init(sizeof(int32_t), sizeof(int64_t), 1000, 5);
+
+  for (int32_t key = 0; key < 500; ++key) {
+    int64_t value = (int64_t)key * 3;
+    clru_cache_put(c, &key, &value);
+  }
+  ck_assert_uint_eq(clru_cache_size(c), 500);
+
+  for (int32_t key = 0; key < 500; ++key) {
+    int64_t value;
+    ck_assert_int_eq(clru_cache_get(c, &key, &value), 1);
+    ck_assert_int_eq(value, (int64_t)key * 3);
+  }
+  for (int32_t key = 0; key < 500; key += 2) {
+    ck_assert_int_eq(clru_cache_remove(c, &key), 1);
+  }
+  ck_assert_uint_eq(clru_cache_size(c), 250);
+
+  lru_stats stats = clru_cache_stats(c);
+  ck_assert_uint_eq(stats.hits, 500);
+  ck_assert_uint_eq(stats.misses, 0);
+  clru_cache_deinit(c);
+}
+END_TEST
+
+START_TEST(test_capacity_is_bounded) {
+  clru_cache* c = clru_cache_init(sizeof(int32_t), sizeof(int32_t), 64, 4);
+
+  for (int32_t key = 0; key < 1000; ++key) {
+    clru_cache_put(c, &key, &key);
+  }
+  ck_assert_uint_eq(clru_cache_size(c), 64);
+  ck_assert_uint_eq(clru_cache_stats(c).evictions, 1000 - 64);
+  clru_cache_deinit(c);
+}
+END_TEST
+
+typedef struct {
+  clru_cache* cache;
+  uint64_t seed;
+  size_t gets;
+  size_t wrong;
+} worker_arg;
+
+/* Every value is derived from its key, so any hit can be checked */
+static void* worker(void* p) {
+  worker_arg* arg = p;
+  uint64_t x = arg->seed;
+  for (size_t i = 0; i < OPS_PER_THREAD; ++i) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    uint32_t key = (uint32_t)(x % KEYS);
+    uint64_t value = (uint64_t)key * 0x9e3779b97f4a7c15ull;
+
+    if ((x >> 40) % 4 == 0) {
+      clru_cache_put(arg->cache, &key, &value);
+    } else if ((x >> 40) % 16 == 1) {
+      clru_cache_remove(arg->cache, &key);
+    } else {
+      uint64_t found;
+      arg->gets += 1;
+      if (clru_cache_get(arg->cache, &key, &found))
+        arg->wrong += found != value;
+    }
+  }
+  return NULL;
+}
+
+START_TEST(test_concurrent_access) {
+  clru_cache* c = clru_cache_init(sizeof(uint32_t), sizeof(uint64_t), 1024, 8);
+
+  pthread_t threads[THREADS];
+  worker_arg args[THREADS];
+  for (size_t t = 0; t < THREADS; ++t) {
+    args[t] = (worker_arg){c, 0x2545f4914f6cdd1dull + t, 0, 0};
+    pthread_create(&threads[t], NULL, worker, &args[t]);
+  }
+
+  size_t gets = 0;
+  for (size_t t = 0; t < THREADS; ++t) {
+    pthread_join(threads[t], NULL);
+    gets += args[t].gets;
+    ck_assert_uint_eq(args[t].wrong, 0);
+  }
+
+  lru_stats stats = clru_cache_stats(c);
+  ck_assert_uint_eq(stats.hits + stats.misses, gets);
+  ck_assert_uint_gt(stats.hits, 0);
+  ck_assert_uint_le(clru_cache_size(c), 1024);
+  clru_cache_deinit(c);
+}
+END_TEST
+
+/******************************* END TESTS ***********************************/
+
+Suite* clru_cache_test_suite(void) {
+  Suite* s = suite_create("clru_cache");
+  TCase* tc_core = tcase_create("core");
+
+  tcase_add_test(tc_core, test_clru_cache_create_and_delete);
+  tcase_add_test(tc_core, test_put_get_remove);
+  tcase_add_test(tc_core, test_capacity_is_bounded);
+  tcase_add_test(tc_core, test_concurrent_access);
+
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+int main(void) {
+  Suite* s = clru_cache_test_suite();
+  SRunner* sr = srunner_create(s);
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,244 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <check.h>
+#include <gal/columnar.h>
+
+/********************************* TESTS *************************************/
+
+typedef struct {
+  int32_t id;
+  double price;
+  char tag;
+  int64_t quantity;
+} record;
+
+static columnar_field const record_fields[] = {
+    COLUMNAR_FIELD(record, id),
+    COLUMNAR_FIELD(record, price),
+    COLUMNAR_FIELD(record, tag),
+    COLUMNAR_FIELD(record, quantity),
+};
+
+enum { ID, PRICE, TAG, QUANTITY };
+
+static columnar* record_columnar(void) {
+  return columnar_init(record_fields, 4, sizeof(record));
+}
+
+static record make_record(int32_t i) {
+  record r;
+  memset(&r, 0, sizeof(r));
+  r.id = i;
+  r.price = i * 0.5;
+  r.tag = (char)('a' + i % 26);
+  r.quantity = (int64_t)i * 1000;
+  return r;
+}
+
+/* Compares field by field; the padding of a returned record is unspecified */
+static int record_eq(record const* a, record const* b) {
+  return a->id == b->id && a->price == b->price && a->tag == b->tag &&
+         a->quantity == b->quantity;
+}
+
+static int cmp_int32(void const* a, void const* b) {
+  int32_t x = *(int32_t const*)a, y = *(int32_t const*)b;
+  return (x > y) - (x < y);
+}
+
+static int cmp_char(void const* a, void const* b) {
+  return *(char const*)a - *(char const*)b;
+}
+
+static int is_tag_z(void const* value) { return *(char const*)value == 'z'; }
+
+static int is_tag_missing(void const* value) {
+  return *(char const*)value == '!';
+}
+
+START_TEST(test_columnar_create_and_delete) {
+  columnar* c = record_columnar();
+  ck_assert_uint_eq(columnar_size(c), 0);
+  columnar_deinit(c);
+}
+END_TEST
+
+START_TEST(test_columns_are_aligned) {
+  columnar* c = record_columnar();
+
+  for (int32_t i = 0; i < 100; ++i) {
+    record r = make_record(i);
+    ck_assert_int_eq(columnar_push_row(c, &r), 0);
+  }
+
+  for (size_t f = 0; f < 4; ++f) {
+    ck_assert_uint_eq((uintptr_t)columnar_column(c, f) % COLUMNAR_ALIGNMENT,
+                      0);
+  }
+
+  columnar_deinit(c);
+}
+END_TEST
+
+START_TEST(test_push_and_get_rows) {
+  columnar* c = record_columnar();
+
+  for (int32_t i = 0; i < 100; ++i) {
+    record r = make_record(i);
+    ck_assert_int_eq(columnar_push_row(c, &r), 0);
+  }
+
+  ck_assert_uint_eq(columnar_size(c), 100);
+  int32_t const* ids = columnar_column(c, ID);
+  for (int32_t i = 0; i < 100; ++i) {
+    record expected = make_record(i);
+    record r;
+    memset(&r, 0, sizeof(r));
+    columnar_get_row(c, i, &r);
+    ck_assert(record_eq(&r, &expected));
+    ck_assert_int_eq(ids[i], i);
+  }
+
+  columnar_deinit(c);
+}
+END_TEST
+
+START_TEST(test_push_rows_and_gather) {
+  columnar* c = record_columnar();
+  record rows[300];
+  for (int32_t i = 0; i < 300; ++i) {
+    rows[i] = make_record(i);
+  }
+
+  ck_assert_int_eq(columnar_push_rows(c, rows, 10), 0);
+  ck_assert_int_eq(columnar_push_rows(c, rows + 10, 290), 0);
+  ck_assert_uint_eq(columnar_size(c), 300);
+
+  record out[50];
+  memset(out, 0, sizeof(out));
+  columnar_gather(c, 120, 50, out);
+  for (size_t i = 0; i < 50; ++i) {
+    ck_assert(record_eq(&out[i], &rows[120 + i]));
+  }
+
+  columnar_deinit(c);
+}
+END_TEST
+
+START_TEST(test_set_row) {
+  columnar* c = record_columnar();
+  for (int32_t i = 0; i < 10; ++i) {
+    record r = make_record(i);
+    columnar_push_row(c, &r);
+  }
+
+  record r = make_record(77);
+  columnar_set_row(c, 4, &r);
+  ck_assert_int_eq(*(int32_t*)columnar_at(c, ID, 4), 77);
+  ck_assert_int_eq(*(int64_t*)columnar_at(c, QUANTITY, 4), 77000);
+  ck_assert_int_eq(*(int32_t*)columnar_at(c, ID, 5), 5);
+
+  columnar_deinit(c);
+}
+END_TEST
+
+START_TEST(test_find_in_column) {
+  columnar* c = record_columnar();
+  for (int32_t i = 0; i < 60; ++i) {
+    record r = make_record(i);
+    columnar_push_row(c, &r);
+  }
+
+  ck_assert_uint_eq(columnar_find(c, TAG, is_tag_z), 25);
+  ck_assert_uint_eq(columnar_find(c, TAG, is_tag_missing), VECTOR_NPOS);
+
+  columnar_deinit(c);
+}
+END_TEST
+
+START_TEST(test_sort_by_permutes_all_columns) {
+  columnar* c = record_columnar();
+  for (int32_t i = 0; i < 1000; ++i) {
+    record r = make_record((i * 7919) % 1000);
+    columnar_push_row(c, &r);
+  }
+
+  ck_assert_int_eq(columnar_sort_by(c, ID, cmp_int32), 0);
+
+  for (int32_t i = 0; i < 1000; ++i) {
+    record expected = make_record(i);
+    record r;
+    memset(&r, 0, sizeof(r));
+    columnar_get_row(c, i, &r);
+    ck_assert(record_eq(&r, &expected));
+  }
+
+  for (int32_t key = 0; key < 1000; key += 37) {
+    ck_assert_uint_eq(columnar_bsearch(c, ID, &key, cmp_int32), key);
+  }
+  int32_t missing = 1000;
+  ck_assert_uint_eq(columnar_bsearch(c, ID, &missing, cmp_int32),
+                    VECTOR_NPOS);
+
+  columnar_deinit(c);
+}
+END_TEST
+
+START_TEST(test_sort_by_is_stable) {
+  columnar* c = record_columnar();
+  for (int32_t i = 0; i < 260; ++i) {
+    record r = make_record(i);
+    columnar_push_row(c, &r);
+  }
+
+  ck_assert_int_eq(columnar_sort_by(c, TAG, cmp_char), 0);
+
+  for (size_t i = 1; i < 260; ++i) {
+    char prev = *(char*)columnar_at(c, TAG, i - 1);
+    char cur = *(char*)columnar_at(c, TAG, i);
+    ck_assert_int_le(prev, cur);
+    if (prev == cur)
+      ck_assert_int_lt(*(int32_t*)columnar_at(c, ID, i - 1),
+                       *(int32_t*)columnar_at(c, ID, i));
+  }
+
+  /* columns stay usable after their buffers were exchanged */
+  for (int32_t i = 260; i < 1000; ++i) {
+    record r = make_record(i);
+    columnar_push_row(c, &r);
+  }
+  ck_assert_int_eq(*(int64_t*)columnar_at(c, QUANTITY, 999), 999000);
+
+  columnar_deinit(c);
+}
+END_TEST
+
+/******************************* END TESTS ***********************************/
+
+Suite* columnar_test_suite(void) {
+  Suite* s = suite_create("columnar");
+  TCase* tc_core = tcase_create("core");
+
+  tcase_add_test(tc_core, test_columnar_create_and_delete);
+  tcase_add_test(tc_core, test_columns_are_aligned);
+  tcase_add_test(tc_core, test_push_and_get_rows);
+  tcase_add_test(tc_core, test_push_rows_and_gather);
+  tcase_add_test(tc_core, test_set_row);
+  tcase_add_test(tc_core, test_find_in_column);
+  tcase_add_test(tc_core, test_sort_by_permutes_all_columns);
+  tcase_add_test(tc_core, test_sort_by_is_stable);
+
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+int main(void) {
+  Suite* s = columnar_test_suite();
+  SRunner* sr = srunner_create(s);
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,244 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <check.h>
+#include <gal/cow_vector.h>
+
+/********************************* TESTS *************************************/
+
+#define READERS 3
+#define WRITES 20000
+
+static int32_t get(cow_vector* v, size_t i) {
+  return *(int32_t const*)cow_vector_at(v, i);
+}
+
+static int32_t snapshot_get(cow_snapshot* s, size_t i) {
+  return *(int32_t const*)cow_snapshot_at(s, i);
+}
+
+START_TEST(test_cow_vector_create_and_delete) {
+  cow_vector* v = cow_vector_init(4);
+  ck_assert_uint_eq(cow_vector_size(v), 0);
+  cow_vector_deinit(v);
+}
+END_TEST
+
+START_TEST(test_push_grows_tree) {
+  cow_vector* v = cow_vector_init(4);
+
+  /* enough for three levels of inner nodes */
+  for (int32_t i = 0; i < 40000; ++i) {
+    ck_assert_int_eq(cow_vector_push(v, &i), 0);
+  }
+
+  ck_assert_uint_eq(cow_vector_size(v), 40000);
+  for (int32_t i = 0; i < 40000; ++i) {
+    ck_assert_int_eq(get(v, i), i);
+  }
+
+  cow_vector_deinit(v);
+}
+END_TEST
+
+START_TEST(test_replace) {
+  cow_vector* v = cow_vector_init(4);
+  for (int32_t i = 0; i < 100; ++i) {
+    cow_vector_push(v, &i);
+  }
+
+  int32_t e = -1;
+  ck_assert_int_eq(cow_vector_replace(v, 63, &e), 0);
+  ck_assert_int_eq(get(v, 63), -1);
+  ck_assert_int_eq(get(v, 62), 62);
+  ck_assert_int_eq(get(v, 64), 64);
+
+  cow_vector_deinit(v);
+}
+END_TEST
+
+START_TEST(test_snapshot_is_immutable) {
+  cow_vector* v = cow_vector_init(4);
+  for (int32_t i = 0; i < 1000; ++i) {
+    cow_vector_push(v, &i);
+  }
+
+  cow_snapshot* s = cow_vector_snapshot(v);
+
+  for (int32_t i = 0; i < 1000; i += 3) {
+    int32_t e = -i;
+    cow_vector_replace(v, i, &e);
+  }
+  for (int32_t i = 1000; i < 2000; ++i) {
+    cow_vector_push(v, &i);
+  }
+
+  ck_assert_uint_eq(cow_snapshot_size(s), 1000);
+  for (int32_t i = 0; i < 1000; ++i) {
+    ck_assert_int_eq(snapshot_get(s, i), i);
+    ck_assert_int_eq(get(v, i), i % 3 == 0 ? -i : i);
+  }
+  ck_assert_uint_eq(cow_vector_size(v), 2000);
+
+  cow_snapshot_release(s);
+  cow_vector_deinit(v);
+}
+END_TEST
+
+START_TEST(test_snapshot_outlives_vector) {
+  cow_vector* v = cow_vector_init(8);
+  for (int64_t i = 0; i < 100; ++i) {
+    cow_vector_push(v, &i);
+  }
+
+  cow_snapshot* s = cow_vector_snapshot(v);
+  cow_vector_deinit(v);
+
+  ck_assert_int_eq(*(int64_t const*)cow_snapshot_at(s, 99), 99);
+  cow_snapshot_release(s);
+}
+END_TEST
+
+START_TEST(test_many_snapshots) {
+  cow_vector* v = cow_vector_init(4);
+  cow_snapshot* snapshots[50];
+
+  for (int32_t i = 0; i < 50; ++i) {
+    cow_vector_push(v, &i);
+    int32_t e = i * 10;
+    cow_vector_replace(v, 0, &e);
+    snapshots[i] = cow_vector_snapshot(v);
+  }
+
+  for (int32_t i = 0; i < 50; ++i) {
+    ck_assert_uint_eq(cow_snapshot_size(snapshots[i]), (size_t)i + 1);
+    ck_assert_int_eq(snapshot_get(snapshots[i], 0), i * 10);
+    if (i > 0)
+      ck_assert_int_eq(snapshot_get(snapshots[i], i), i);
+  }
+
+  for (int32_t i = 49; i >= 0; --i) {
+    cow_snapshot_release(snapshots[i]);
+  }
+  cow_vector_deinit(v);
+}
+END_TEST
+
+START_TEST(test_acquire_before_publish) {
+  cow_vector* v = cow_vector_init(4);
+  int32_t e = 1;
+  cow_vector_push(v, &e);
+
+  cow_snapshot* s = cow_vector_acquire(v);
+  ck_assert_uint_eq(cow_snapshot_size(s), 0);
+  cow_snapshot_release(s);
+
+  ck_assert_int_eq(cow_vector_publish(v), 0);
+  s = cow_vector_acquire(v);
+  ck_assert_uint_eq(cow_snapshot_size(s), 1);
+  cow_snapshot_release(s);
+
+  cow_vector_deinit(v);
+}
+END_TEST
+
+typedef struct {
+  cow_vector* v;
+  atomic_int done;
+  atomic_int inconsistent;
+} stress_ctx;
+
+/* Every published version holds element i == i + generation, where the
+ * generation is stored in the last element */
+static void* reader(void* arg) {
+  stress_ctx* ctx = arg;
+
+  while (!atomic_load(&ctx->done)) {
+    cow_snapshot* s = cow_vector_acquire(ctx->v);
+    size_t size = cow_snapshot_size(s);
+    if (size > 0) {
+      int32_t generation = snapshot_get(s, size - 1);
+      for (size_t i = 0; i + 1 < size; ++i) {
+        if (snapshot_get(s, i) != (int32_t)i + generation)
+          atomic_store(&ctx->inconsistent, 1);
+      }
+    }
+    cow_snapshot_release(s);
+  }
+
+  return NULL;
+}
+
+START_TEST(test_concurrent_readers) {
+  stress_ctx ctx = {cow_vector_init(4), 0, 0};
+
+  for (int32_t i = 0; i < 200; ++i) {
+    cow_vector_push(ctx.v, &i);
+  }
+  int32_t generation = 0;
+  cow_vector_push(ctx.v, &generation);
+  cow_vector_publish(ctx.v);
+
+  pthread_t readers[READERS];
+  for (size_t i = 0; i < READERS; ++i) {
+    pthread_create(&readers[i], NULL, reader, &ctx);
+  }
+
+  for (int32_t w = 1; w <= WRITES; ++w) {
+    size_t size = cow_vector_size(ctx.v);
+    if (w % 100 == 0) {
+      /* a new generation rewrites every element */
+      generation = w;
+      for (size_t i = 0; i + 1 < size; ++i) {
+        int32_t e = (int32_t)i + generation;
+        cow_vector_replace(ctx.v, i, &e);
+      }
+      cow_vector_replace(ctx.v, size - 1, &generation);
+    } else if (w % 10 == 0) {
+      /* grow by moving the generation marker one slot right */
+      int32_t e = (int32_t)size - 1 + generation;
+      cow_vector_replace(ctx.v, size - 1, &e);
+      cow_vector_push(ctx.v, &generation);
+    }
+    cow_vector_publish(ctx.v);
+  }
+
+  atomic_store(&ctx.done, 1);
+  for (size_t i = 0; i < READERS; ++i) {
+    pthread_join(readers[i], NULL);
+  }
+
+  ck_assert_int_eq(atomic_load(&ctx.inconsistent), 0);
+  cow_vector_deinit(ctx.v);
+}
+END_TEST
+
+/******************************* END TESTS ***********************************/
+
+Suite* cow_vector_test_suite(void) {
+  Suite* s = suite_create("cow_vector");
+  TCase* tc_core = tcase_create("core");
+
+  tcase_add_test(tc_core, test_cow_vector_create_and_delete);
+  tcase_add_test(tc_core, test_push_grows_tree);
+  tcase_add_test(tc_core, test_replace);
+  tcase_add_test(tc_core, test_snapshot_is_immutable);
+  tcase_add_test(tc_core, test_snapshot_outlives_vector);
+  tcase_add_test(tc_core, test_many_snapshots);
+  tcase_add_test(tc_core, test_acquire_before_publish);
+  tcase_add_test(tc_core, test_concurrent_readers);
+
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+int main(void) {
+  Suite* s = cow_vector_test_suite();
+  SRunner* sr = srunner_create(s);
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
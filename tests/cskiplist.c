@@ -0,0 +1,208 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <check.h>
+#include <gal/cskiplist.h>
+
+/********************************* TESTS *************************************/
+
+#define THREADS 4
+#define KEYS_PER_THREAD 5000
+
+static int cmp_int32(void const* a, void const* b) {
+  int32_t x = *(int32_t const*)a, y = *(int32_t const*)b;
+  return (x > y) - (x < y);
+}
+
+START_TEST(test_cskiplist_create_and_delete) {
+  cskiplist* sl = cskiplist_init(4, cmp_int32);
+  ck_assert_uint_eq(cskiplist_size(sl), 0);
+  ck_assert_ptr_null(cskiplist_first(sl));
+  cskiplist_deinit(sl);
+}
+END_TEST
+
+START_TEST(test_insert_find_remove) {
+  cskiplist* sl = cskiplist_init(4, cmp_int32);
+
+  for (int32_t i = 0; i < 500; ++i) {
+    int32_t e = (i * 7919) % 500;
+    ck_assert_int_eq(cskiplist_insert(sl, &e), 1);
+  }
+  int32_t dup = 42;
+  ck_assert_int_eq(cskiplist_insert(sl, &dup), 0);
+  ck_assert_uint_eq(cskiplist_size(sl), 500);
+
+  for (int32_t key = 0; key < 500; key += 2) {
+    ck_assert_int_eq(cskiplist_remove(sl, &key), 1);
+    ck_assert_int_eq(cskiplist_remove(sl, &key), 0);
+  }
+  ck_assert_uint_eq(cskiplist_size(sl), 250);
+
+  for (int32_t key = 0; key < 500; ++key) {
+    void const* found = cskiplist_find(sl, &key);
+    if (key % 2 == 0) {
+      ck_assert_ptr_null(found);
+    } else {
+      ck_assert_ptr_nonnull(found);
+      ck_assert_int_eq(*(int32_t const*)found, key);
+    }
+  }
+
+  int32_t expected = 1;
+  for (cskiplist_node* node = cskiplist_first(sl); node;
+       node = cskiplist_next(node)) {
+    ck_assert_int_eq(*(int32_t const*)cskiplist_data(node), expected);
+    expected += 2;
+  }
+  ck_assert_int_eq(expected, 501);
+
+  cskiplist_deinit(sl);
+}
+END_TEST
+
+START_TEST(test_reinsert_after_remove) {
+  cskiplist* sl = cskiplist_init(4, cmp_int32);
+
+  int32_t e = 9;
+  for (int i = 0; i < 5; ++i) {
+    ck_assert_int_eq(cskiplist_insert(sl, &e), 1);
+    ck_assert_int_eq(cskiplist_insert(sl, &e), 0);
+    ck_assert_int_eq(cskiplist_remove(sl, &e), 1);
+  }
+  ck_assert_ptr_null(cskiplist_find(sl, &e));
+  ck_assert_int_eq(cskiplist_insert(sl, &e), 1);
+  ck_assert_ptr_nonnull(cskiplist_find(sl, &e));
+
+  cskiplist_compact(sl);
+  ck_assert_uint_eq(cskiplist_size(sl), 1);
+  ck_assert_ptr_nonnull(cskiplist_find(sl, &e));
+  ck_assert_ptr_eq(cskiplist_next(cskiplist_first(sl)), NULL);
+
+  cskiplist_deinit(sl);
+}
+END_TEST
+
+START_TEST(test_compact) {
+  cskiplist* sl = cskiplist_init(4, cmp_int32);
+
+  for (int32_t i = 0; i < 1000; ++i) {
+    cskiplist_insert(sl, &i);
+  }
+  for (int32_t i = 0; i < 1000; i += 3) {
+    cskiplist_remove(sl, &i);
+  }
+  cskiplist_compact(sl);
+
+  for (int32_t i = 0; i < 1000; ++i) {
+    ck_assert((cskiplist_find(sl, &i) != NULL) == (i % 3 != 0));
+  }
+
+  cskiplist_deinit(sl);
+}
+END_TEST
+
+typedef struct {
+  cskiplist* sl;
+  int32_t first;
+  atomic_int* inserted;
+} writer_arg;
+
+/* Every thread inserts its own keys interleaved with the other threads'
+ * keys and removes every fourth of them again */
+static void* writer(void* p) {
+  writer_arg* arg = p;
+  for (int32_t i = 0; i < KEYS_PER_THREAD; ++i) {
+    int32_t key = i * THREADS + arg->first;
+    if (cskiplist_insert(arg->sl, &key) == 1)
+      atomic_fetch_add(arg->inserted, 1);
+    if (i % 4 == 0)
+      cskiplist_remove(arg->sl, &key);
+  }
+  return NULL;
+}
+
+/* Competes with the writers for the keys of thread 0 */
+static void* competitor(void* p) {
+  writer_arg* arg = p;
+  for (int32_t i = 0; i < KEYS_PER_THREAD; ++i) {
+    int32_t key = i * THREADS;
+    if (cskiplist_insert(arg->sl, &key) == 1)
+      atomic_fetch_add(arg->inserted, 1);
+  }
+  return NULL;
+}
+
+START_TEST(test_concurrent_inserts) {
+  cskiplist* sl = cskiplist_init(4, cmp_int32);
+  atomic_int inserted = 0;
+
+  pthread_t threads[THREADS + 1];
+  writer_arg args[THREADS];
+  for (int32_t t = 0; t < THREADS; ++t) {
+    args[t] = (writer_arg){sl, t, &inserted};
+    pthread_create(&threads[t], NULL, writer, &args[t]);
+  }
+  pthread_create(&threads[THREADS], NULL, competitor, &args[0]);
+  for (size_t t = 0; t <= THREADS; ++t) {
+    pthread_join(threads[t], NULL);
+  }
+
+  /* keys of threads 1.. that were not removed must be present; keys of
+   * thread 0 may have been re-inserted by the competitor */
+  size_t live = 0;
+  int32_t prev = -1;
+  for (cskiplist_node* node = cskiplist_first(sl); node;
+       node = cskiplist_next(node)) {
+    int32_t key = *(int32_t const*)cskiplist_data(node);
+    ck_assert_int_gt(key, prev);
+    prev = key;
+    live += 1;
+  }
+  ck_assert_uint_eq(live, cskiplist_size(sl));
+
+  for (int32_t t = 1; t < THREADS; ++t) {
+    for (int32_t i = 0; i < KEYS_PER_THREAD; ++i) {
+      int32_t key = i * THREADS + t;
+      ck_assert((cskiplist_find(sl, &key) != NULL) == (i % 4 != 0));
+    }
+  }
+  for (int32_t i = 0; i < KEYS_PER_THREAD; ++i) {
+    int32_t key = i * THREADS;
+    if (i % 4 != 0)
+      ck_assert_ptr_nonnull(cskiplist_find(sl, &key));
+  }
+
+  cskiplist_compact(sl);
+  ck_assert_uint_eq(cskiplist_size(sl), live);
+
+  cskiplist_deinit(sl);
+}
+END_TEST
+
+/******************************* END TESTS ***********************************/
+
+Suite* cskiplist_test_suite(void) {
+  Suite* s = suite_create("cskiplist");
+  TCase* tc_core = tcase_create("core");
+
+  tcase_add_test(tc_core, test_cskiplist_create_and_delete);
+  tcase_add_test(tc_core, test_insert_find_remove);
+  tcase_add_test(tc_core, test_reinsert_after_remove);
+  tcase_add_test(tc_core, test_compact);
+  tcase_add_test(tc_core, test_concurrent_inserts);
+
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+int main(void) {
+  Suite* s = cskiplist_test_suite();
+  SRunner* sr = srunner_create(s);
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
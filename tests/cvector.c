@@ -0,0 +1,151 @@
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <check.h>
+#include <gal/cvector.h>
+
+/********************************* TESTS *************************************/
+
+#define WRITERS 4
+#define PUSHES_PER_WRITER 20000
+
+START_TEST(test_cvector_create_and_delete) {
+  cvector* cv = cvector_init(4);
+
+  ck_assert_uint_eq(cvector_size(cv), 0);
+
+  cvector_deinit(cv);
+}
+END_TEST
+
+START_TEST(test_push_across_segments) {
+  cvector* cv = cvector_init(4);
+
+  for (int32_t i = 0; i < 100; ++i) {
+    ck_assert_uint_eq(cvector_push(cv, &i), (size_t)i);
+  }
+
+  ck_assert_uint_eq(cvector_size(cv), 100);
+  for (int32_t i = 0; i < 100; ++i) {
+    ck_assert_int_eq(*(int32_t*)cvector_at(cv, i), i);
+  }
+
+  cvector_deinit(cv);
+}
+END_TEST
+
+START_TEST(test_elements_do_not_move) {
+  cvector* cv = cvector_init(4);
+
+  int32_t e = 7;
+  cvector_push(cv, &e);
+  int32_t* first = cvector_at(cv, 0);
+
+  for (int32_t i = 0; i < 1000; ++i) {
+    cvector_push(cv, &i);
+  }
+
+  ck_assert_ptr_eq(cvector_at(cv, 0), first);
+  ck_assert_int_eq(*first, 7);
+
+  cvector_deinit(cv);
+}
+END_TEST
+
+START_TEST(test_push_n_spans_segments) {
+  cvector* cv = cvector_init(4);
+
+  int32_t items[50];
+  for (int32_t i = 0; i < 50; ++i) {
+    items[i] = i;
+  }
+
+  ck_assert_uint_eq(cvector_push_n(cv, items, 10), 0);
+  ck_assert_uint_eq(cvector_push_n(cv, items, 50), 10);
+
+  ck_assert_uint_eq(cvector_size(cv), 60);
+  ck_assert_int_eq(*(int32_t*)cvector_at(cv, 9), 9);
+  for (int32_t i = 0; i < 50; ++i) {
+    ck_assert_int_eq(*(int32_t*)cvector_at(cv, 10 + i), i);
+  }
+
+  cvector_deinit(cv);
+}
+END_TEST
+
+START_TEST(test_freeze_to_vector) {
+  cvector* cv = cvector_init(4);
+
+  for (int32_t i = 0; i < 40; ++i) {
+    cvector_push(cv, &i);
+  }
+
+  vector* v = cvector_freeze(cv);
+
+  ck_assert_uint_eq(vector_size(v), 40);
+  for (int32_t i = 0; i < 40; ++i) {
+    ck_assert_int_eq(*(int32_t*)vector_at(v, i), i);
+  }
+
+  vector_deinit(v);
+}
+END_TEST
+
+static void* writer(void* arg) {
+  cvector* cv = arg;
+  for (uint32_t i = 0; i < PUSHES_PER_WRITER; ++i) {
+    cvector_push(cv, &i);
+  }
+  return NULL;
+}
+
+START_TEST(test_concurrent_writers) {
+  cvector* cv = cvector_init(4);
+  pthread_t threads[WRITERS];
+
+  for (int i = 0; i < WRITERS; ++i) {
+    pthread_create(&threads[i], NULL, writer, cv);
+  }
+  for (int i = 0; i < WRITERS; ++i) {
+    pthread_join(threads[i], NULL);
+  }
+
+  ck_assert_uint_eq(cvector_size(cv), WRITERS * PUSHES_PER_WRITER);
+
+  uint64_t sum = 0;
+  for (size_t i = 0; i < cvector_size(cv); ++i) {
+    sum += *(uint32_t*)cvector_at(cv, i);
+  }
+  ck_assert_uint_eq(sum, (uint64_t)WRITERS * PUSHES_PER_WRITER *
+                             (PUSHES_PER_WRITER - 1) / 2);
+
+  cvector_deinit(cv);
+}
+END_TEST
+
+/******************************* END TESTS ***********************************/
+
+Suite* cvector_test_suite(void) {
+  Suite* s = suite_create("cvector");
+  TCase* tc_core = tcase_create("core");
+
+  tcase_add_test(tc_core, test_cvector_create_and_delete);
+  tcase_add_test(tc_core, test_push_across_segments);
+  tcase_add_test(tc_core, test_elements_do_not_move);
+  tcase_add_test(tc_core, test_push_n_spans_segments);
+  tcase_add_test(tc_core, test_freeze_to_vector);
+  tcase_add_test(tc_core, test_concurrent_writers);
+
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+int main(void) {
+  Suite* s = cvector_test_suite();
+  SRunner* sr = srunner_create(s);
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,101 @@
+#include <stdlib.h>
+
+#include <check.h>
+#include <gal/dlist.h>
+
+/********************************* TESTS *************************************/
+
+/* Links three nodes holding 1, 2 and 3 into `lst` by hand; only the inline
+ * traversal code of the header is exercised */
+static void link_three(dlist* lst, dlist* nodes, int* values) {
+  for (size_t i = 0; i < 3; ++i) {
+    nodes[i].head = lst;
+    nodes[i].tail = lst;
+    nodes[i].left = i > 0 ? &nodes[i - 1] : NULL;
+    nodes[i].right = i < 2 ? &nodes[i + 1] : NULL;
+    nodes[i].data = &values[i];
+  }
+  lst->head = &nodes[0];
+  lst->tail = &nodes[2];
+  lst->left = NULL;
+  lst->right = NULL;
+  lst->data = NULL;
+}
+
+START_TEST(test_foreach) {
+  dlist lst, nodes[3];
+  int values[] = {1, 2, 3};
+  link_three(&lst, nodes, values);
+
+  int expected = 1;
+  DLIST_FOREACH(node, &lst) {
+    ck_assert_int_eq(*(int*)node->data, expected);
+    expected += 1;
+  }
+  ck_assert_int_eq(expected, 4);
+
+  DLIST_FOREACH_REVERSE(node, &lst) {
+    expected -= 1;
+    ck_assert_int_eq(*(int*)node->data, expected);
+  }
+  ck_assert_int_eq(expected, 1);
+}
+END_TEST
+
+START_TEST(test_cursor) {
+  dlist lst, nodes[3];
+  int values[] = {1, 2, 3};
+  link_three(&lst, nodes, values);
+
+  dlist_cursor c = dlist_cursor_front(&lst);
+  for (int expected = 1; expected <= 3; ++expected) {
+    ck_assert(dlist_cursor_valid(c));
+    ck_assert_int_eq(*(int*)dlist_cursor_get(c), expected);
+    dlist_cursor_next(&c);
+  }
+  ck_assert(!dlist_cursor_valid(c));
+
+  c = dlist_cursor_back(&lst);
+  ck_assert_ptr_eq(dlist_cursor_node(c), &nodes[2]);
+  dlist_cursor_prev(&c);
+  ck_assert_int_eq(*(int*)dlist_cursor_get(c), 2);
+  dlist_cursor_prev(&c);
+  dlist_cursor_prev(&c);
+  ck_assert(!dlist_cursor_valid(c));
+}
+END_TEST
+
+START_TEST(test_empty) {
+  dlist lst = {NULL, NULL, NULL, NULL, NULL};
+
+  DLIST_FOREACH(node, &lst) {
+    (void)node;
+    ck_abort();
+  }
+  ck_assert(!dlist_cursor_valid(dlist_cursor_front(&lst)));
+  ck_assert(!dlist_cursor_valid(dlist_cursor_back(&lst)));
+}
+END_TEST
+
+/******************************* END TESTS ***********************************/
+
+Suite* dlist_test_suite(void) {
+  Suite* s = suite_create("dlist");
+  TCase* tc_core = tcase_create("core");
+
+  tcase_add_test(tc_core, test_foreach);
+  tcase_add_test(tc_core, test_cursor);
+  tcase_add_test(tc_core, test_empty);
+
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+int main(void) {
+  Suite* s = dlist_test_suite();
+  SRunner* sr = srunner_create(s);
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
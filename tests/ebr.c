@@ -0,0 +1,199 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <check.h>
+#include <gal/allocator.h>
+#include <gal/ebr.h>
+
+/********************************* TESTS *************************************/
+
+#define READERS 3
+#define UPDATES 20000
+#define NODE_MAGIC 0x5eed5eedu
+#define BLOCK_SIZE 16
+
+static atomic_size_t freed_nodes;
+
+static void* counting_allocator(void* ptr, size_t old_size, size_t new_size) {
+  if (ptr && old_size == BLOCK_SIZE && new_size == 0)
+    atomic_fetch_add(&freed_nodes, 1);
+  return gal_std_allocator(ptr, old_size, new_size);
+}
+
+typedef struct {
+  uint32_t magic;
+  uint32_t value;
+} node;
+
+typedef struct {
+  gal_ebr* ebr;
+  node* _Atomic shared;
+  atomic_int done;
+  atomic_int corrupted;
+} stress_ctx;
+
+static void* reader(void* arg) {
+  stress_ctx* ctx = arg;
+  gal_ebr_thread* t = gal_ebr_register(ctx->ebr);
+
+  while (!atomic_load(&ctx->done)) {
+    gal_ebr_enter(t);
+    node* n = atomic_load(&ctx->shared);
+    if (n->magic != NODE_MAGIC)
+      atomic_store(&ctx->corrupted, 1);
+    gal_ebr_exit(t);
+  }
+
+  gal_ebr_unregister(t);
+  return NULL;
+}
+
+START_TEST(test_ebr_create_and_delete) {
+  gal_ebr* ebr = gal_ebr_init(NULL);
+  gal_ebr_thread* t = gal_ebr_register(ebr);
+
+  gal_ebr_unregister(t);
+  gal_ebr_deinit(ebr);
+}
+END_TEST
+
+START_TEST(test_retired_node_waits_for_two_epochs) {
+  atomic_store(&freed_nodes, 0);
+  gal_ebr* ebr = gal_ebr_init(counting_allocator);
+  gal_ebr_thread* t = gal_ebr_register(ebr);
+
+  gal_ebr_enter(t);
+  gal_ebr_retire(t, malloc(BLOCK_SIZE), BLOCK_SIZE);
+  gal_ebr_exit(t);
+  ck_assert_uint_eq(gal_ebr_pending(t), 1);
+
+  gal_ebr_collect(t);
+  ck_assert_uint_eq(gal_ebr_pending(t), 1);
+
+  gal_ebr_collect(t);
+  ck_assert_uint_eq(gal_ebr_pending(t), 0);
+  ck_assert_uint_eq(atomic_load(&freed_nodes), 1);
+
+  gal_ebr_unregister(t);
+  gal_ebr_deinit(ebr);
+}
+END_TEST
+
+START_TEST(test_active_thread_blocks_reclamation) {
+  gal_ebr* ebr = gal_ebr_init(NULL);
+  gal_ebr_thread* writer = gal_ebr_register(ebr);
+  gal_ebr_thread* stalled = gal_ebr_register(ebr);
+
+  gal_ebr_enter(stalled);
+  gal_ebr_retire(writer, malloc(BLOCK_SIZE), BLOCK_SIZE);
+
+  for (int i = 0; i < 10; ++i) {
+    gal_ebr_collect(writer);
+  }
+  ck_assert_uint_eq(gal_ebr_pending(writer), 1);
+
+  gal_ebr_exit(stalled);
+  gal_ebr_collect(writer);
+  gal_ebr_collect(writer);
+  ck_assert_uint_eq(gal_ebr_pending(writer), 0);
+
+  gal_ebr_unregister(stalled);
+  gal_ebr_unregister(writer);
+  gal_ebr_deinit(ebr);
+}
+END_TEST
+
+START_TEST(test_unregistered_state_is_reused) {
+  gal_ebr* ebr = gal_ebr_init(NULL);
+  gal_ebr_thread* first = gal_ebr_register(ebr);
+  gal_ebr_unregister(first);
+
+  gal_ebr_thread* second = gal_ebr_register(ebr);
+  ck_assert_ptr_eq(first, second);
+
+  gal_ebr_unregister(second);
+  gal_ebr_deinit(ebr);
+}
+END_TEST
+
+START_TEST(test_deinit_frees_pending_nodes) {
+  atomic_store(&freed_nodes, 0);
+  gal_ebr* ebr = gal_ebr_init(counting_allocator);
+  gal_ebr_thread* t = gal_ebr_register(ebr);
+
+  for (int i = 0; i < 5; ++i) {
+    gal_ebr_retire(t, malloc(BLOCK_SIZE), BLOCK_SIZE);
+  }
+  gal_ebr_unregister(t);
+  gal_ebr_deinit(ebr);
+
+  ck_assert_uint_eq(atomic_load(&freed_nodes), 5);
+}
+END_TEST
+
+START_TEST(test_concurrent_readers) {
+  stress_ctx ctx;
+  ctx.ebr = gal_ebr_init(NULL);
+  atomic_init(&ctx.done, 0);
+  atomic_init(&ctx.corrupted, 0);
+
+  node* first = malloc(sizeof(node));
+  first->magic = NODE_MAGIC;
+  first->value = 0;
+  atomic_init(&ctx.shared, first);
+
+  pthread_t threads[READERS];
+  for (int i = 0; i < READERS; ++i) {
+    pthread_create(&threads[i], NULL, reader, &ctx);
+  }
+
+  gal_ebr_thread* t = gal_ebr_register(ctx.ebr);
+  for (uint32_t i = 1; i <= UPDATES; ++i) {
+    node* n = malloc(sizeof(node));
+    n->magic = NODE_MAGIC;
+    n->value = i;
+    node* old = atomic_exchange(&ctx.shared, n);
+    gal_ebr_retire(t, old, sizeof(node));
+  }
+
+  atomic_store(&ctx.done, 1);
+  for (int i = 0; i < READERS; ++i) {
+    pthread_join(threads[i], NULL);
+  }
+
+  ck_assert_int_eq(atomic_load(&ctx.corrupted), 0);
+  ck_assert_uint_lt(gal_ebr_pending(t), UPDATES);
+
+  gal_ebr_unregister(t);
+  free(atomic_load(&ctx.shared));
+  gal_ebr_deinit(ctx.ebr);
+}
+END_TEST
+
+/******************************* END TESTS ***********************************/
+
+Suite* ebr_test_suite(void) {
+  Suite* s = suite_create("ebr");
+  TCase* tc_core = tcase_create("core");
+
+  tcase_add_test(tc_core, test_ebr_create_and_delete);
+  tcase_add_test(tc_core, test_retired_node_waits_for_two_epochs);
+  tcase_add_test(tc_core, test_active_thread_blocks_reclamation);
+  tcase_add_test(tc_core, test_unregistered_state_is_reused);
+  tcase_add_test(tc_core, test_deinit_frees_pending_nodes);
+  tcase_add_test(tc_core, test_concurrent_readers);
+
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+int main(void) {
+  Suite* s = ebr_test_suite();
+  SRunner* sr = srunner_create(s);
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
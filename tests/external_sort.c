@@ -0,0 +1,159 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <check.h>
+#include <gal/external_sort.h>
+
+/********************************* TESTS *************************************/
+
+int cmp_uint32_t(void const* a, void const* b) {
+  uint32_t _a = *(uint32_t*)a, _b = *(uint32_t*)b;
+  if (_a < _b)
+    return -1;
+  if (_a > _b)
+    return 1;
+  return 0;
+}
+
+typedef struct {
+  uint32_t last;
+  size_t count;
+  uint64_t sum;
+  int ordered;
+} check_ctx;
+
+static void check_order(void const* item, void* arg) {
+  check_ctx* ctx = arg;
+  uint32_t value = *(uint32_t const*)item;
+  if (ctx->count > 0 && value < ctx->last)
+    ctx->ordered = 0;
+  ctx->last = value;
+  ctx->sum += value;
+  ctx->count += 1;
+}
+
+static uint32_t next_random(uint32_t* state) {
+  *state ^= *state << 13;
+  *state ^= *state >> 17;
+  *state ^= *state << 5;
+  return *state;
+}
+
+/* Pushes n pseudo-random values and returns their sum */
+static uint64_t push_random(external_sort* s, size_t n) {
+  uint32_t state = 2463534242u;
+  uint64_t sum = 0;
+  for (size_t i = 0; i < n; ++i) {
+    uint32_t value = next_random(&state) % 100000;
+    external_sort_push(s, &value);
+    sum += value;
+  }
+  return sum;
+}
+
+START_TEST(test_sort_in_memory) {
+  external_sort* s = external_sort_init(4, 1 << 20, cmp_uint32_t, NULL);
+  uint64_t sum = push_random(s, 1000);
+
+  check_ctx ctx = {0, 0, 0, 1};
+  ck_assert_int_eq(external_sort_finish(s, check_order, &ctx), 0);
+
+  ck_assert(ctx.ordered);
+  ck_assert_uint_eq(ctx.count, 1000);
+  ck_assert_uint_eq(ctx.sum, sum);
+
+  external_sort_deinit(s);
+}
+END_TEST
+
+START_TEST(test_sort_single_merge_pass) {
+  external_sort* s = external_sort_init(4, 1 << 20, cmp_uint32_t, NULL);
+  uint64_t sum = push_random(s, 1000000);
+
+  check_ctx ctx = {0, 0, 0, 1};
+  ck_assert_int_eq(external_sort_finish(s, check_order, &ctx), 0);
+
+  ck_assert(ctx.ordered);
+  ck_assert_uint_eq(ctx.count, 1000000);
+  ck_assert_uint_eq(ctx.sum, sum);
+
+  external_sort_deinit(s);
+}
+END_TEST
+
+START_TEST(test_sort_several_merge_passes) {
+  external_sort* s = external_sort_init(4, 256, cmp_uint32_t, NULL);
+  uint64_t sum = push_random(s, 5000);
+
+  check_ctx ctx = {0, 0, 0, 1};
+  ck_assert_int_eq(external_sort_finish(s, check_order, &ctx), 0);
+
+  ck_assert(ctx.ordered);
+  ck_assert_uint_eq(ctx.count, 5000);
+  ck_assert_uint_eq(ctx.sum, sum);
+
+  external_sort_deinit(s);
+}
+END_TEST
+
+START_TEST(test_sort_batches_to_file) {
+  char path[] = "/tmp/gal_sort_test_XXXXXX";
+  int fd = mkstemp(path);
+  unlink(path);
+
+  external_sort* s = external_sort_init(4, 1024, cmp_uint32_t, "/tmp");
+  uint32_t items[700];
+  for (uint32_t i = 0; i < 700; ++i) {
+    items[i] = 699 - i;
+  }
+  ck_assert_int_eq(external_sort_push_n(s, items, 700), 0);
+  ck_assert_int_eq(external_sort_finish_fd(s, fd), 0);
+  external_sort_deinit(s);
+
+  uint32_t sorted[700];
+  ck_assert_int_eq(pread(fd, sorted, sizeof(sorted), 0), sizeof(sorted));
+  for (uint32_t i = 0; i < 700; ++i) {
+    ck_assert_uint_eq(sorted[i], i);
+  }
+
+  close(fd);
+}
+END_TEST
+
+START_TEST(test_sort_nothing) {
+  external_sort* s = external_sort_init(4, 1024, cmp_uint32_t, NULL);
+
+  check_ctx ctx = {0, 0, 0, 1};
+  ck_assert_int_eq(external_sort_finish(s, check_order, &ctx), 0);
+  ck_assert_uint_eq(ctx.count, 0);
+
+  external_sort_deinit(s);
+}
+END_TEST
+
+/******************************* END TESTS ***********************************/
+
+Suite* external_sort_test_suite(void) {
+  Suite* s = suite_create("external_sort");
+  TCase* tc_core = tcase_create("core");
+
+  tcase_add_test(tc_core, test_sort_in_memory);
+  tcase_add_test(tc_core, test_sort_single_merge_pass);
+  tcase_add_test(tc_core, test_sort_several_merge_passes);
+  tcase_add_test(tc_core, test_sort_batches_to_file);
+  tcase_add_test(tc_core, test_sort_nothing);
+
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+int main(void) {
+  Suite* s = external_sort_test_suite();
+  SRunner* sr = srunner_create(s);
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,196 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <check.h>
+#include <gal/intseq.h>
+#include <gal/vector.h>
+
+/********************************* TESTS *************************************/
+
+static uint64_t next_random(uint64_t* x) {
+  *x ^= *x << 13;
+  *x ^= *x >> 7;
+  *x ^= *x << 17;
+  return *x;
+}
+
+/* Sorted values whose gaps are below 2^bits, with runs of duplicates */
+static uint64_t* sorted_values(size_t n, unsigned bits, uint64_t seed) {
+  uint64_t* values = malloc(n * sizeof(uint64_t));
+  uint64_t x = seed;
+  uint64_t value = next_random(&x) >> 40;
+  for (size_t i = 0; i < n; ++i) {
+    uint64_t r = next_random(&x);
+    if (r % 7 != 0)
+      value += r & ((UINT64_C(1) << bits) - 1);
+    values[i] = value;
+  }
+  return values;
+}
+
+static size_t reference_lower_bound(uint64_t const* values, size_t n,
+                                    uint64_t key) {
+  size_t i = 0;
+  while (i < n && values[i] < key) {
+    ++i;
+  }
+  return i;
+}
+
+START_TEST(test_intseq_empty) {
+  intseq* seq = intseq_init(NULL, 0);
+  ck_assert_uint_eq(intseq_size(seq), 0);
+  ck_assert_uint_eq(intseq_lower_bound(seq, 42), 0);
+
+  intseq_iter it;
+  uint64_t value;
+  intseq_iter_init(&it, seq, 0);
+  ck_assert_int_eq(intseq_iter_next(&it, &value), 0);
+  intseq_deinit(seq);
+}
+END_TEST
+
+START_TEST(test_random_access) {
+  unsigned widths[] = {0, 1, 5, 13, 31, 53, 57, 61};
+
+  for (size_t w = 0; w < sizeof(widths) / sizeof(widths[0]); ++w) {
+    /* few enough values that the sum of the gaps can not overflow */
+    size_t n = widths[w] > 53 ? (size_t)1 << (63 - widths[w]) : 1000;
+    uint64_t* values = sorted_values(n, widths[w], w + 1);
+    intseq* seq = intseq_init(values, n);
+
+    ck_assert_uint_eq(intseq_size(seq), n);
+    for (size_t i = 0; i < n; ++i) {
+      ck_assert_uint_eq(intseq_at(seq, i), values[i]);
+    }
+
+    intseq_deinit(seq);
+    free(values);
+  }
+}
+END_TEST
+
+START_TEST(test_full_width_deltas) {
+  uint64_t values[] = {0, UINT64_MAX - 1, UINT64_MAX, UINT64_MAX};
+  intseq* seq = intseq_init(values, 4);
+
+  for (size_t i = 0; i < 4; ++i) {
+    ck_assert_uint_eq(intseq_at(seq, i), values[i]);
+  }
+  ck_assert_uint_eq(intseq_lower_bound(seq, 1), 1);
+  ck_assert_uint_eq(intseq_lower_bound(seq, UINT64_MAX), 2);
+
+  intseq_deinit(seq);
+}
+END_TEST
+
+START_TEST(test_lower_bound) {
+  size_t n = 3000;
+  uint64_t* values = sorted_values(n, 4, 99);
+  intseq* seq = intseq_init(values, n);
+
+  uint64_t x = 7;
+  for (size_t k = 0; k < 2000; ++k) {
+    uint64_t key = values[0] + next_random(&x) % (values[n - 1] - values[0] +
+                                                   10);
+    ck_assert_uint_eq(intseq_lower_bound(seq, key),
+                      reference_lower_bound(values, n, key));
+  }
+  for (size_t i = 0; i < n; ++i) {
+    ck_assert_uint_eq(intseq_lower_bound(seq, values[i]),
+                      reference_lower_bound(values, n, values[i]));
+  }
+  ck_assert_uint_eq(intseq_lower_bound(seq, 0), 0);
+  ck_assert_uint_eq(intseq_lower_bound(seq, values[n - 1] + 1), n);
+
+  intseq_deinit(seq);
+  free(values);
+}
+END_TEST
+
+START_TEST(test_lower_bound_duplicates_across_blocks) {
+  size_t n = 3 * INTSEQ_BLOCK_SIZE;
+  uint64_t* values = malloc(n * sizeof(uint64_t));
+  for (size_t i = 0; i < n; ++i) {
+    values[i] = i < 10 ? i : 100;
+  }
+  intseq* seq = intseq_init(values, n);
+
+  ck_assert_uint_eq(intseq_lower_bound(seq, 100), 10);
+  ck_assert_uint_eq(intseq_lower_bound(seq, 50), 10);
+  ck_assert_uint_eq(intseq_lower_bound(seq, 101), n);
+
+  intseq_deinit(seq);
+  free(values);
+}
+END_TEST
+
+START_TEST(test_iteration) {
+  size_t n = 1000;
+  uint64_t* values = sorted_values(n, 20, 5);
+  intseq* seq = intseq_init(values, n);
+
+  size_t starts[] = {0, 1, 127, 128, 500, 999, 1000};
+  for (size_t s = 0; s < sizeof(starts) / sizeof(starts[0]); ++s) {
+    intseq_iter it;
+    uint64_t value;
+    size_t i = starts[s];
+    intseq_iter_init(&it, seq, i);
+    while (intseq_iter_next(&it, &value)) {
+      ck_assert_uint_eq(value, values[i]);
+      ++i;
+    }
+    ck_assert_uint_eq(i, n);
+  }
+
+  intseq_deinit(seq);
+  free(values);
+}
+END_TEST
+
+START_TEST(test_from_vector_compresses) {
+  vector* v = vector_init(sizeof(uint64_t));
+  uint64_t id = UINT64_C(1) << 40;
+  for (size_t i = 0; i < 100000; ++i) {
+    id += 1 + i % 5;
+    vector_push(v, &id);
+  }
+
+  intseq* seq = intseq_from_vector(v);
+  ck_assert_uint_eq(intseq_size(seq), 100000);
+  ck_assert_uint_eq(intseq_at(seq, 99999), id);
+  /* gaps below 8 take 3 bits each */
+  ck_assert_uint_lt(intseq_memory_usage(seq) * 8,
+                    vector_size(v) * sizeof(uint64_t));
+
+  intseq_deinit(seq);
+  vector_deinit(v);
+}
+END_TEST
+
+/******************************* END TESTS ***********************************/
+
+Suite* intseq_test_suite(void) {
+  Suite* s = suite_create("intseq");
+  TCase* tc_core = tcase_create("core");
+
+  tcase_add_test(tc_core, test_intseq_empty);
+  tcase_add_test(tc_core, test_random_access);
+  tcase_add_test(tc_core, test_full_width_deltas);
+  tcase_add_test(tc_core, test_lower_bound);
+  tcase_add_test(tc_core, test_lower_bound_duplicates_across_blocks);
+  tcase_add_test(tc_core, test_iteration);
+  tcase_add_test(tc_core, test_from_vector_compresses);
+
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+int main(void) {
+  Suite* s = intseq_test_suite();
+  SRunner* sr = srunner_create(s);
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,271 @@
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <check.h>
+#include <gal/lru_cache.h>
+
+/********************************* TESTS *************************************/
+
+START_TEST(test_lru_cache_create_and_delete) {
+  lru_cache* c = lru_cache_init(4, 8, 10);
+  ck_assert_ptr_nonnull(c);
+  ck_assert_uint_eq(lru_cache_size(c), 0);
+  ck_assert_uint_eq(lru_cache_capacity(c), 10);
+
+  int32_t key = 1;
+  ck_assert_ptr_null(lru_cache_get(c, &key));
+  lru_stats stats = lru_cache_stats(c);
+  ck_assert_uint_eq(stats.hits, 0);
+  ck_assert_uint_eq(stats.misses, 1);
+  ck_assert_uint_eq(stats.evictions, 0);
+  lru_cache_deinit(c);
+}
+END_TEST
+
+START_TEST(test_put_get_replace) {
+  lru_cache* c = lru_cache_init(sizeof(int32_t), sizeof(int64_t), 100);
+
+  for (int32_t key = 0; key < 100; ++key) {
+    int64_t value = key * 10;
+    int64_t* stored = lru_cache_put(c, &key, &value);
+    ck_assert_int_eq(*stored, value);
+  }
+  ck_assert_uint_eq(lru_cache_size(c), 100);
+
+  for (int32_t key = 0; key < 100; ++key) {
+    int64_t* value = lru_cache_get(c, &key);
+    ck_assert_ptr_nonnull(value);
+    ck_assert_int_eq(*value, key * 10);
+  }
+
+  int32_t key = 42;
+  int64_t value = -1;
+  lru_cache_put(c, &key, &value);
+  ck_assert_uint_eq(lru_cache_size(c), 100);
+  ck_assert_int_eq(*(int64_t*)lru_cache_peek(c, &key), -1);
+
+  /* the value is left to the caller */
+  key = 1000;
+  *(int64_t*)lru_cache_put(c, &key, NULL) = 7;
+  ck_assert_int_eq(*(int64_t*)lru_cache_get(c, &key), 7);
+
+  lru_stats stats = lru_cache_stats(c);
+  ck_assert_uint_eq(stats.hits, 101);
+  ck_assert_uint_eq(stats.misses, 0);
+  ck_assert_uint_eq(stats.evictions, 1);
+  lru_cache_deinit(c);
+}
+END_TEST
+
+START_TEST(test_eviction_order) {
+  lru_cache* c = lru_cache_init(sizeof(int32_t), sizeof(int32_t), 4);
+
+  for (int32_t key = 1; key <= 4; ++key) {
+    lru_cache_put(c, &key, &key);
+  }
+  int32_t key = 1;
+  lru_cache_get(c, &key);
+  /* peek does not refresh 2 */
+  key = 2;
+  lru_cache_peek(c, &key);
+
+  key = 5;
+  lru_cache_put(c, &key, &key);
+  key = 2;
+  ck_assert_ptr_null(lru_cache_peek(c, &key));
+  key = 6;
+  lru_cache_put(c, &key, &key);
+  key = 3;
+  ck_assert_ptr_null(lru_cache_peek(c, &key));
+  ck_assert_uint_eq(lru_cache_stats(c).evictions, 2);
+
+  /* remaining entries from least to most recently used */
+  int32_t expected[] = {4, 1, 5, 6};
+  for (size_t i = 0; i < 4; ++i) {
+    int32_t k, v;
+    ck_assert_int_eq(lru_cache_pop(c, &k, &v), 1);
+    ck_assert_int_eq(k, expected[i]);
+    ck_assert_int_eq(v, expected[i]);
+  }
+  ck_assert_int_eq(lru_cache_pop(c, NULL, NULL), 0);
+  ck_assert_uint_eq(lru_cache_stats(c).evictions, 2);
+  lru_cache_deinit(c);
+}
+END_TEST
+
+START_TEST(test_remove_and_clear) {
+  lru_cache* c = lru_cache_init(sizeof(int32_t), sizeof(int32_t), 64);
+
+  for (int32_t key = 0; key < 64; ++key) {
+    lru_cache_put(c, &key, &key);
+  }
+  for (int32_t key = 0; key < 64; key += 2) {
+    ck_assert_int_eq(lru_cache_remove(c, &key), 1);
+    ck_assert_int_eq(lru_cache_remove(c, &key), 0);
+  }
+  ck_assert_uint_eq(lru_cache_size(c), 32);
+  for (int32_t key = 0; key < 64; ++key) {
+    int32_t* value = lru_cache_peek(c, &key);
+    if (key % 2)
+      ck_assert_int_eq(*value, key);
+    else
+      ck_assert_ptr_null(value);
+  }
+
+  /* freed entries are reused without evicting */
+  for (int32_t key = 100; key < 132; ++key) {
+    lru_cache_put(c, &key, &key);
+  }
+  ck_assert_uint_eq(lru_cache_size(c), 64);
+  ck_assert_uint_eq(lru_cache_stats(c).evictions, 0);
+
+  lru_cache_clear(c);
+  ck_assert_uint_eq(lru_cache_size(c), 0);
+  int32_t key = 101;
+  ck_assert_ptr_null(lru_cache_peek(c, &key));
+  for (key = 0; key < 64; ++key) {
+    lru_cache_put(c, &key, &key);
+  }
+  ck_assert_uint_eq(lru_cache_size(c), 64);
+  ck_assert_uint_eq(lru_cache_stats(c).evictions, 0);
+  lru_cache_deinit(c);
+}
+END_TEST
+
+#define MODEL_CAPACITY 50
+#define MODEL_KEYS 200
+
+/* Reference LRU: the last use of every key, 0 if it is not cached */
+typedef struct {
+  uint64_t used[MODEL_KEYS];
+  int32_t values[MODEL_KEYS];
+  size_t size;
+  uint64_t clock;
+} lru_model;
+
+static void model_evict(lru_model* m) {
+  size_t oldest = MODEL_KEYS;
+  for (size_t k = 0; k < MODEL_KEYS; ++k) {
+    if (m->used[k] && (oldest == MODEL_KEYS || m->used[k] < m->used[oldest]))
+      oldest = k;
+  }
+  m->used[oldest] = 0;
+  m->size -= 1;
+}
+
+static uint64_t next_random(uint64_t* x) {
+  *x ^= *x << 13;
+  *x ^= *x >> 7;
+  *x ^= *x << 17;
+  return *x;
+}
+
+START_TEST(test_against_model) {
+  lru_cache* c =
+      lru_cache_init(sizeof(int32_t), sizeof(int32_t), MODEL_CAPACITY);
+  lru_model m = {{0}, {0}, 0, 0};
+  uint64_t rng = 12345;
+  size_t hits = 0, misses = 0, evictions = 0;
+
+  for (size_t op = 0; op < 100000; ++op) {
+    uint64_t r = next_random(&rng);
+    int32_t key = (int32_t)(r % MODEL_KEYS);
+    m.clock += 1;
+
+    switch ((r >> 32) % 4) {
+    case 0:
+    case 1: {
+      int32_t* value = lru_cache_get(c, &key);
+      if (m.used[key]) {
+        ck_assert_ptr_nonnull(value);
+        ck_assert_int_eq(*value, m.values[key]);
+        m.used[key] = m.clock;
+        hits += 1;
+      } else {
+        ck_assert_ptr_null(value);
+        misses += 1;
+      }
+      break;
+    }
+    case 2: {
+      int32_t value = (int32_t)op;
+      lru_cache_put(c, &key, &value);
+      if (!m.used[key]) {
+        if (m.size == MODEL_CAPACITY) {
+          model_evict(&m);
+          evictions += 1;
+        }
+        m.size += 1;
+      }
+      m.used[key] = m.clock;
+      m.values[key] = value;
+      break;
+    }
+    default:
+      ck_assert_int_eq(lru_cache_remove(c, &key), m.used[key] != 0);
+      if (m.used[key]) {
+        m.used[key] = 0;
+        m.size -= 1;
+      }
+    }
+    ck_assert_uint_eq(lru_cache_size(c), m.size);
+  }
+
+  lru_stats stats = lru_cache_stats(c);
+  ck_assert_uint_eq(stats.hits, hits);
+  ck_assert_uint_eq(stats.misses, misses);
+  ck_assert_uint_eq(stats.evictions, evictions);
+  lru_cache_deinit(c);
+}
+END_TEST
+
+START_TEST(test_odd_key_size) {
+  char keys[][7] = {"abcdef", "abcdeg", "bbcdef", "abcdeF"};
+  lru_cache* c = lru_cache_init(7, sizeof(int), 3);
+
+  for (int i = 0; i < 4; ++i) {
+    lru_cache_put(c, keys[i], &i);
+  }
+  ck_assert_ptr_null(lru_cache_get(c, keys[0]));
+  for (int i = 1; i < 4; ++i) {
+    ck_assert_int_eq(*(int*)lru_cache_get(c, keys[i]), i);
+  }
+  lru_cache_deinit(c);
+}
+END_TEST
+
+START_TEST(test_init_failure) {
+  errno = 0;
+  lru_cache* c = lru_cache_init(8, SIZE_MAX / 4, LRU_CACHE_MAX_CAPACITY);
+  ck_assert_ptr_null(c);
+  ck_assert_int_eq(errno, ENOMEM);
+}
+END_TEST
+
+/******************************* END TESTS ***********************************/
+
+Suite* lru_cache_test_suite(void) {
+  Suite* s = suite_create("lru_cache");
+  TCase* tc_core = tcase_create("core");
+
+  tcase_add_test(tc_core, test_lru_cache_create_and_delete);
+  tcase_add_test(tc_core, test_put_get_replace);
+  tcase_add_test(tc_core, test_eviction_order);
+  tcase_add_test(tc_core, test_remove_and_clear);
+  tcase_add_test(tc_core, test_against_model);
+  tcase_add_test(tc_core, test_odd_key_size);
+  tcase_add_test(tc_core, test_init_failure);
+
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+int main(void) {
+  Suite* s = lru_cache_test_suite();
+  SRunner* sr = srunner_create(s);
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,164 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <check.h>
+#include <gal/skiplist.h>
+
+/********************************* TESTS *************************************/
+
+static int cmp_int32(void const* a, void const* b) {
+  int32_t x = *(int32_t const*)a, y = *(int32_t const*)b;
+  return (x > y) - (x < y);
+}
+
+static int32_t value(skiplist_node* node) {
+  return *(int32_t*)skiplist_data(node);
+}
+
+/* Inserts 0, 2, ..., 2 * (n - 1) in a scrambled order */
+static skiplist* even_numbers(int32_t n) {
+  skiplist* sl = skiplist_init(4, cmp_int32);
+  for (int32_t i = 0; i < n; ++i) {
+    int32_t e = ((i * 7919) % n) * 2;
+    skiplist_insert(sl, &e);
+  }
+  return sl;
+}
+
+START_TEST(test_skiplist_create_and_delete) {
+  skiplist* sl = skiplist_init(4, cmp_int32);
+  ck_assert_uint_eq(skiplist_size(sl), 0);
+  ck_assert_ptr_null(skiplist_first(sl));
+  ck_assert_ptr_null(skiplist_last(sl));
+  skiplist_deinit(sl);
+}
+END_TEST
+
+START_TEST(test_insert_keeps_order) {
+  skiplist* sl = even_numbers(1000);
+
+  ck_assert_uint_eq(skiplist_size(sl), 1000);
+  int32_t expected = 0;
+  SKIPLIST_FOREACH(node, sl) {
+    ck_assert_int_eq(value(node), expected);
+    expected += 2;
+  }
+  ck_assert_int_eq(expected, 2000);
+
+  expected = 1998;
+  SKIPLIST_FOREACH_REVERSE(node, sl) {
+    ck_assert_int_eq(value(node), expected);
+    expected -= 2;
+  }
+  ck_assert_int_eq(expected, -2);
+
+  skiplist_deinit(sl);
+}
+END_TEST
+
+START_TEST(test_insert_duplicate) {
+  skiplist* sl = even_numbers(10);
+
+  int32_t e = 4;
+  ck_assert_int_eq(skiplist_insert(sl, &e), 0);
+  ck_assert_uint_eq(skiplist_size(sl), 10);
+
+  skiplist_deinit(sl);
+}
+END_TEST
+
+START_TEST(test_find_and_lower_bound) {
+  skiplist* sl = even_numbers(1000);
+
+  for (int32_t key = 0; key < 1999; ++key) {
+    skiplist_node* node = skiplist_find(sl, &key);
+    if (key % 2 == 0) {
+      ck_assert_ptr_nonnull(node);
+      ck_assert_int_eq(value(node), key);
+    } else {
+      ck_assert_ptr_null(node);
+    }
+
+    skiplist_node* bound = skiplist_lower_bound(sl, &key);
+    ck_assert_ptr_nonnull(bound);
+    ck_assert_int_eq(value(bound), key + key % 2);
+  }
+
+  int32_t past = 1999;
+  ck_assert_ptr_null(skiplist_lower_bound(sl, &past));
+
+  skiplist_deinit(sl);
+}
+END_TEST
+
+START_TEST(test_remove) {
+  skiplist* sl = even_numbers(1000);
+
+  for (int32_t key = 0; key < 2000; key += 6) {
+    ck_assert_int_eq(skiplist_remove(sl, &key), 1);
+    ck_assert_int_eq(skiplist_remove(sl, &key), 0);
+  }
+  int32_t odd = 5;
+  ck_assert_int_eq(skiplist_remove(sl, &odd), 0);
+
+  int32_t expected = 2;
+  size_t count = 0;
+  SKIPLIST_FOREACH(node, sl) {
+    ck_assert_int_eq(value(node), expected);
+    expected += expected % 6 == 4 ? 4 : 2;
+    count += 1;
+  }
+  ck_assert_uint_eq(count, skiplist_size(sl));
+  ck_assert_int_eq(value(skiplist_last(sl)), 1996);
+
+  size_t reverse = 0;
+  SKIPLIST_FOREACH_REVERSE(node, sl) { reverse += 1; }
+  ck_assert_uint_eq(reverse, count);
+
+  skiplist_deinit(sl);
+}
+END_TEST
+
+START_TEST(test_remove_all) {
+  skiplist* sl = even_numbers(100);
+
+  for (int32_t key = 0; key < 200; key += 2) {
+    ck_assert_int_eq(skiplist_remove(sl, &key), 1);
+  }
+  ck_assert_uint_eq(skiplist_size(sl), 0);
+  ck_assert_ptr_null(skiplist_first(sl));
+  ck_assert_ptr_null(skiplist_last(sl));
+
+  int32_t e = 7;
+  ck_assert_int_eq(skiplist_insert(sl, &e), 1);
+  ck_assert_ptr_eq(skiplist_first(sl), skiplist_last(sl));
+
+  skiplist_deinit(sl);
+}
+END_TEST
+
+/******************************* END TESTS ***********************************/
+
+Suite* skiplist_test_suite(void) {
+  Suite* s = suite_create("skiplist");
+  TCase* tc_core = tcase_create("core");
+
+  tcase_add_test(tc_core, test_skiplist_create_and_delete);
+  tcase_add_test(tc_core, test_insert_keeps_order);
+  tcase_add_test(tc_core, test_insert_duplicate);
+  tcase_add_test(tc_core, test_find_and_lower_bound);
+  tcase_add_test(tc_core, test_remove);
+  tcase_add_test(tc_core, test_remove_all);
+
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+int main(void) {
+  Suite* s = skiplist_test_suite();
+  SRunner* sr = srunner_create(s);
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,170 @@
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <check.h>
+#include <gal/spsc_ring.h>
+
+/********************************* TESTS *************************************/
+
+#define TRANSFER_COUNT 100000
+
+START_TEST(test_ring_create_and_delete) {
+  spsc_ring* r = spsc_ring_init(4, 10);
+
+  ck_assert_uint_eq(spsc_ring_capacity(r), 16);
+  ck_assert_uint_eq(spsc_ring_size(r), 0);
+
+  spsc_ring_deinit(r);
+}
+END_TEST
+
+START_TEST(test_push_and_pop) {
+  spsc_ring* r = spsc_ring_init(4, 4);
+
+  for (int32_t i = 0; i < 4; ++i) {
+    ck_assert(spsc_ring_push(r, &i));
+  }
+
+  int32_t e = 10;
+  ck_assert(!spsc_ring_push(r, &e));
+  ck_assert_uint_eq(spsc_ring_size(r), 4);
+
+  for (int32_t i = 0; i < 4; ++i) {
+    ck_assert(spsc_ring_pop(r, &e));
+    ck_assert_int_eq(e, i);
+  }
+
+  ck_assert(!spsc_ring_pop(r, &e));
+
+  spsc_ring_deinit(r);
+}
+END_TEST
+
+START_TEST(test_batch_wraps_around) {
+  spsc_ring* r = spsc_ring_init(4, 8);
+
+  int32_t in[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+  int32_t out[8] = {0};
+
+  ck_assert_uint_eq(spsc_ring_push_n(r, in, 6), 6);
+  ck_assert_uint_eq(spsc_ring_pop_n(r, out, 5), 5);
+
+  /* tail is at slot 6, so this push is split in two copies */
+  ck_assert_uint_eq(spsc_ring_push_n(r, in, 8), 7);
+  ck_assert_uint_eq(spsc_ring_pop_n(r, out, 8), 8);
+
+  ck_assert_int_eq(out[0], 5);
+  for (int i = 1; i < 8; ++i) {
+    ck_assert_int_eq(out[i], i - 1);
+  }
+
+  spsc_ring_deinit(r);
+}
+END_TEST
+
+START_TEST(test_reserve_and_peek_spans) {
+  spsc_ring* r = spsc_ring_init(4, 8);
+  size_t count;
+
+  int32_t in[6] = {0, 1, 2, 3, 4, 5};
+  int32_t out[6];
+  spsc_ring_push_n(r, in, 6);
+  spsc_ring_pop_n(r, out, 6);
+
+  /* only two slots are left before the end of the buffer */
+  int32_t* span = spsc_ring_reserve(r, 5, &count);
+  ck_assert_uint_eq(count, 2);
+  span[0] = 42;
+  span[1] = 43;
+  spsc_ring_commit(r, 2);
+
+  span = spsc_ring_reserve(r, 3, &count);
+  ck_assert_uint_eq(count, 3);
+  span[0] = 44;
+  spsc_ring_commit(r, 1);
+
+  int32_t const* view = spsc_ring_peek(r, 8, &count);
+  ck_assert_uint_eq(count, 2);
+  ck_assert_int_eq(view[0], 42);
+  ck_assert_int_eq(view[1], 43);
+  spsc_ring_release(r, 2);
+
+  view = spsc_ring_peek(r, 8, &count);
+  ck_assert_uint_eq(count, 1);
+  ck_assert_int_eq(view[0], 44);
+  spsc_ring_release(r, 1);
+
+  ck_assert_ptr_null(spsc_ring_peek(r, 8, &count));
+  ck_assert_uint_eq(count, 0);
+
+  spsc_ring_deinit(r);
+}
+END_TEST
+
+static void* producer(void* arg) {
+  spsc_ring* r = arg;
+  uint64_t batch[7];
+  uint64_t next = 0;
+
+  while (next < TRANSFER_COUNT) {
+    size_t n = 0;
+    while (n < 7 && next + n < TRANSFER_COUNT) {
+      batch[n] = next + n;
+      ++n;
+    }
+    next += spsc_ring_push_n(r, batch, n);
+  }
+
+  return NULL;
+}
+
+START_TEST(test_two_threads_keep_order) {
+  spsc_ring* r = spsc_ring_init(8, 64);
+  pthread_t thread;
+  pthread_create(&thread, NULL, producer, r);
+
+  uint64_t expected = 0;
+  int ordered = 1;
+  while (expected < TRANSFER_COUNT) {
+    size_t count;
+    uint64_t const* view = spsc_ring_peek(r, 16, &count);
+    for (size_t i = 0; i < count; ++i) {
+      ordered &= view[i] == expected + i;
+    }
+    spsc_ring_release(r, count);
+    expected += count;
+  }
+
+  pthread_join(thread, NULL);
+  ck_assert(ordered);
+  ck_assert_uint_eq(spsc_ring_size(r), 0);
+
+  spsc_ring_deinit(r);
+}
+END_TEST
+
+/******************************* END TESTS ***********************************/
+
+Suite* spsc_ring_test_suite(void) {
+  Suite* s = suite_create("spsc_ring");
+  TCase* tc_core = tcase_create("core");
+
+  tcase_add_test(tc_core, test_ring_create_and_delete);
+  tcase_add_test(tc_core, test_push_and_pop);
+  tcase_add_test(tc_core, test_batch_wraps_around);
+  tcase_add_test(tc_core, test_reserve_and_peek_spans);
+  tcase_add_test(tc_core, test_two_threads_keep_order);
+
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+int main(void) {
+  Suite* s = spsc_ring_test_suite();
+  SRunner* sr = srunner_create(s);
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,186 @@
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <check.h>
+#include <gal/thread_pool.h>
+
+/********************************* TESTS *************************************/
+
+static void increment(void* arg) { atomic_fetch_add((atomic_int*)arg, 1); }
+
+static void fill_squares(size_t begin, size_t end, void* ctx) {
+  uint64_t* out = ctx;
+  for (size_t i = begin; i < end; ++i) {
+    out[i] = (uint64_t)i * i;
+  }
+}
+
+static void sum_range(size_t begin, size_t end, void* partial, void* ctx) {
+  (void)ctx;
+  for (size_t i = begin; i < end; ++i) {
+    *(uint64_t*)partial += i;
+  }
+}
+
+static void add_partial(void* result, void const* partial, void* ctx) {
+  (void)ctx;
+  *(uint64_t*)result += *(uint64_t const*)partial;
+}
+
+/* Polynomial hash of the index sequence: associative but not commutative,
+ * so it only matches the serial result if partials are combined in order. */
+typedef struct {
+  uint64_t hash;
+  uint64_t scale;
+} poly_hash;
+
+static void hash_range(size_t begin, size_t end, void* partial, void* ctx) {
+  (void)ctx;
+  poly_hash* h = partial;
+  for (size_t i = begin; i < end; ++i) {
+    h->hash = h->hash * 31 + i;
+    h->scale *= 31;
+  }
+}
+
+static void hash_partial(void* result, void const* partial, void* ctx) {
+  (void)ctx;
+  poly_hash* r = result;
+  poly_hash const* p = partial;
+  r->hash = r->hash * p->scale + p->hash;
+  r->scale *= p->scale;
+}
+
+typedef struct {
+  gal_thread_pool* pool;
+  atomic_int* counter;
+} nested_ctx;
+
+static void count_inner(size_t begin, size_t end, void* ctx) {
+  atomic_fetch_add((atomic_int*)ctx, (int)(end - begin));
+}
+
+static void run_nested(size_t begin, size_t end, void* ctx) {
+  nested_ctx* nested = ctx;
+  for (size_t i = begin; i < end; ++i) {
+    gal_parallel_for(nested->pool, 0, 100, 7, count_inner, nested->counter);
+  }
+}
+
+START_TEST(test_pool_create_and_delete) {
+  gal_thread_pool* pool = gal_thread_pool_init(3);
+
+  ck_assert_uint_eq(gal_thread_pool_size(pool), 3);
+
+  gal_thread_pool_deinit(pool);
+}
+END_TEST
+
+START_TEST(test_submit_and_wait) {
+  gal_thread_pool* pool = gal_thread_pool_init(4);
+  atomic_int counter = 0;
+
+  for (int i = 0; i < 1000; ++i) {
+    gal_thread_pool_submit(pool, increment, &counter);
+  }
+  gal_thread_pool_wait(pool);
+
+  ck_assert_int_eq(atomic_load(&counter), 1000);
+
+  gal_thread_pool_deinit(pool);
+}
+END_TEST
+
+START_TEST(test_parallel_for_covers_range) {
+  gal_thread_pool* pool = gal_thread_pool_init(4);
+  uint64_t* out = calloc(10000, sizeof(uint64_t));
+
+  gal_parallel_for(pool, 0, 10000, 0, fill_squares, out);
+
+  for (uint64_t i = 0; i < 10000; ++i) {
+    ck_assert_uint_eq(out[i], i * i);
+  }
+
+  free(out);
+  gal_thread_pool_deinit(pool);
+}
+END_TEST
+
+START_TEST(test_parallel_for_without_pool) {
+  uint64_t out[10] = {0};
+
+  gal_parallel_for(NULL, 2, 10, 0, fill_squares, out);
+
+  ck_assert_uint_eq(out[1], 0);
+  ck_assert_uint_eq(out[9], 81);
+}
+END_TEST
+
+START_TEST(test_parallel_reduce_sum) {
+  gal_thread_pool* pool = gal_thread_pool_init(4);
+  uint64_t sum = 0;
+
+  gal_parallel_reduce(pool, 0, 100000, 0, &sum, sizeof(sum), sum_range,
+                      add_partial, NULL);
+
+  ck_assert_uint_eq(sum, (uint64_t)100000 * 99999 / 2);
+
+  gal_thread_pool_deinit(pool);
+}
+END_TEST
+
+START_TEST(test_parallel_reduce_keeps_order) {
+  gal_thread_pool* pool = gal_thread_pool_init(4);
+  poly_hash serial = {0, 1};
+  poly_hash parallel = {0, 1};
+
+  hash_range(0, 5000, &serial, NULL);
+  gal_parallel_reduce(pool, 0, 5000, 0, &parallel, sizeof(parallel),
+                      hash_range, hash_partial, NULL);
+
+  ck_assert_uint_eq(parallel.hash, serial.hash);
+
+  gal_thread_pool_deinit(pool);
+}
+END_TEST
+
+START_TEST(test_nested_parallel_for) {
+  gal_thread_pool* pool = gal_thread_pool_init(2);
+  atomic_int counter = 0;
+  nested_ctx ctx = {pool, &counter};
+
+  gal_parallel_for(pool, 0, 20, 1, run_nested, &ctx);
+
+  ck_assert_int_eq(atomic_load(&counter), 2000);
+
+  gal_thread_pool_deinit(pool);
+}
+END_TEST
+
+/******************************* END TESTS ***********************************/
+
+Suite* thread_pool_test_suite(void) {
+  Suite* s = suite_create("thread_pool");
+  TCase* tc_core = tcase_create("core");
+
+  tcase_add_test(tc_core, test_pool_create_and_delete);
+  tcase_add_test(tc_core, test_submit_and_wait);
+  tcase_add_test(tc_core, test_parallel_for_covers_range);
+  tcase_add_test(tc_core, test_parallel_for_without_pool);
+  tcase_add_test(tc_core, test_parallel_reduce_sum);
+  tcase_add_test(tc_core, test_parallel_reduce_keeps_order);
+  tcase_add_test(tc_core, test_nested_parallel_for);
+
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+int main(void) {
+  Suite* s = thread_pool_test_suite();
+  SRunner* sr = srunner_create(s);
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -1,5 +1,7 @@
+#include <errno.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <check.h>
 #include <gal/vector.h>
@@ -19,6 +21,10 @@ int cmp_int32_t(void const* a, void const* b) {
   return 0;
 }
 
+int cmp_first_byte(void const* a, void const* b) {
+  return *(unsigned char const*)a - *(unsigned char const*)b;
+}
+
 START_TEST(test_vector_create_and_delete) {
   vector* v = vector_init(4);
   vector_deinit(v);
@@ -30,6 +36,7 @@ START_TEST(test_empty_vector) {
 
   ck_assert(vector_is_empty(v));
   ck_assert(vector_size(v) == 0);
+  ck_assert(vector_element_size(v) == 4);
 
   vector_deinit(v);
 }
@@ -232,6 +239,26 @@ START_TEST(test_remove_on_predicate) {
 }
 END_TEST
 
+START_TEST(test_clear_keeps_capacity) {
+  vector* v = vector_init(4);
+  for (int32_t i = 0; i < 100; ++i) {
+    vector_push(v, &i);
+  }
+  size_t capacity = vector_capacity(v);
+
+  vector_clear(v);
+  ck_assert(vector_is_empty(v));
+  ck_assert_uint_eq(vector_capacity(v), capacity);
+
+  int32_t e = 7;
+  vector_push(v, &e);
+  ck_assert_uint_eq(vector_size(v), 1);
+  ck_assert_int_eq(*(int32_t*)vector_at(v, 0), 7);
+
+  vector_deinit(v);
+}
+END_TEST
+
 START_TEST(test_find_on_predicate) {
   vector* v = vector_init(4);
 
@@ -568,6 +595,256 @@ START_TEST(test_binary_search_same_elements) {
 }
 END_TEST
 
+START_TEST(test_unchecked_access) {
+  vector* v = vector_init(4);
+
+  for (int32_t i = 0; i < 40; ++i) {
+    vector_push(v, &i);
+  }
+
+  ck_assert_ptr_eq(vector_data(v), vector_begin(v));
+  ck_assert_ptr_eq(vector_at_unchecked(v, 0), vector_begin(v));
+  ck_assert_ptr_eq(vector_at_unchecked(v, 17), vector_at(v, 17));
+  ck_assert_int_eq(*(int32_t*)vector_at_unchecked(v, 39), 39);
+
+  int32_t expected = 0;
+  for (int32_t* it = vector_begin(v); it != vector_end(v); ++it) {
+    ck_assert_int_eq(*it, expected++);
+  }
+  ck_assert_int_eq(expected, 40);
+
+  vector_deinit(v);
+}
+END_TEST
+
+START_TEST(test_empty_span) {
+  vector* v = vector_init(4);
+  ck_assert_ptr_eq(vector_begin(v), vector_end(v));
+  vector_deinit(v);
+}
+END_TEST
+
+/* Fails every request for more than 64 bytes */
+static void* limited_allocator(void* ptr, size_t old_size, size_t new_size) {
+  if (new_size > 64)
+    return NULL;
+  return gal_std_allocator(ptr, old_size, new_size);
+}
+
+START_TEST(test_try_push_keeps_vector_on_failure) {
+  vector* v = vector_init_with_allocator(4, limited_allocator);
+
+  for (int32_t i = 0; i < 16; ++i) {
+    ck_assert_int_eq(vector_try_push(v, &i), 0);
+  }
+
+  int32_t e = 16;
+  errno = 0;
+  ck_assert_int_eq(vector_try_push(v, &e), -1);
+  ck_assert_int_eq(errno, ENOMEM);
+  ck_assert_int_eq(vector_try_insert(v, &e, 3), -1);
+
+  ck_assert_uint_eq(vector_size(v), 16);
+  ck_assert_uint_eq(vector_capacity(v), 16);
+  for (int32_t i = 0; i < 16; ++i) {
+    ck_assert_int_eq(*(int32_t*)vector_at(v, i), i);
+  }
+
+  vector_deinit(v);
+}
+END_TEST
+
+START_TEST(test_try_reserve) {
+  vector* v = vector_init_with_allocator(4, limited_allocator);
+
+  ck_assert_int_eq(vector_try_reserve(v, 8), 0);
+  ck_assert_uint_eq(vector_capacity(v), 16);
+  ck_assert_int_eq(vector_try_reserve(v, 17), -1);
+  ck_assert_uint_eq(vector_capacity(v), 16);
+  ck_assert_int_eq(vector_try_resize(v, VECTOR_MAX_SIZE / 2), -1);
+  ck_assert_int_eq(errno, ENOMEM);
+
+  int32_t e = 1;
+  ck_assert_int_eq(vector_try_push(v, &e), 0);
+  ck_assert_int_eq(*(int32_t*)vector_at(v, 0), 1);
+
+  vector_deinit(v);
+}
+END_TEST
+
+START_TEST(test_reserve) {
+  vector* v = vector_init(4);
+
+  vector_reserve(v, 1000);
+  ck_assert_uint_ge(vector_capacity(v), 1000);
+  void* data = vector_data(v);
+
+  for (int32_t i = 0; i < 1000; ++i) {
+    vector_push(v, &i);
+  }
+  ck_assert_ptr_eq(vector_data(v), data);
+
+  vector_deinit(v);
+}
+END_TEST
+
+START_TEST(test_push_n) {
+  vector* v = vector_init(4);
+  int32_t items[100];
+  for (int32_t i = 0; i < 100; ++i) {
+    items[i] = i;
+  }
+
+  vector_push_n(v, items, 10);
+  vector_push_n(v, items + 10, 0);
+  vector_push_n(v, items + 10, 90);
+
+  ck_assert_uint_eq(vector_size(v), 100);
+  ck_assert_uint_ge(vector_capacity(v), 100);
+  for (int32_t i = 0; i < 100; ++i) {
+    ck_assert_int_eq(*(int32_t*)vector_at(v, i), i);
+  }
+
+  vector_deinit(v);
+}
+END_TEST
+
+#ifdef GAL_ALLOC_STATS
+START_TEST(test_push_n_resizes_once) {
+  vector* v = vector_init(4);
+  int32_t items[1000] = {0};
+
+  vector_push_n(v, items, 1000);
+  ck_assert_uint_eq(vector_alloc_stats(v)->reallocs, 1);
+
+  vector_deinit(v);
+}
+END_TEST
+#endif
+
+START_TEST(test_extend) {
+  vector* a = vector_init(4);
+  vector* b = vector_init(4);
+
+  for (int32_t i = 0; i < 20; ++i) {
+    vector_push(a, &i);
+    int32_t j = i + 20;
+    vector_push(b, &j);
+  }
+
+  vector_extend(a, b);
+  ck_assert_uint_eq(vector_size(a), 40);
+  for (int32_t i = 0; i < 40; ++i) {
+    ck_assert_int_eq(*(int32_t*)vector_at(a, i), i);
+  }
+
+  vector_extend(a, a);
+  ck_assert_uint_eq(vector_size(a), 80);
+  for (int32_t i = 0; i < 80; ++i) {
+    ck_assert_int_eq(*(int32_t*)vector_at(a, i), i % 40);
+  }
+
+  vector_deinit(a);
+  vector_deinit(b);
+}
+END_TEST
+
+START_TEST(test_emplace_back) {
+  vector* v = vector_init(sizeof(int64_t));
+
+  for (int64_t i = 0; i < 50; ++i) {
+    int64_t* slot = vector_emplace_back(v);
+    *slot = i * i;
+  }
+
+  ck_assert_uint_eq(vector_size(v), 50);
+  for (int64_t i = 0; i < 50; ++i) {
+    ck_assert_int_eq(*(int64_t*)vector_at(v, i), i * i);
+  }
+
+  vector_deinit(v);
+}
+END_TEST
+
+START_TEST(test_foreach) {
+  vector* v = vector_init(4);
+  for (int32_t i = 0; i < 100; ++i) {
+    vector_push(v, &i);
+  }
+
+  int32_t sum = 0;
+  VECTOR_FOREACH(int32_t, it, v) { sum += *it; }
+  ck_assert_int_eq(sum, 4950);
+
+  vector_deinit(v);
+}
+END_TEST
+
+START_TEST(test_span) {
+  vector* v = vector_init(sizeof(int64_t));
+  for (int64_t i = 0; i < 30; ++i) {
+    vector_push(v, &i);
+  }
+
+  vector_span all = vector_span_of(v);
+  ck_assert_uint_eq(vector_span_size(all), 30);
+  ck_assert_ptr_eq(vector_span_at(all, 7), vector_at(v, 7));
+
+  vector_span part = vector_subspan(v, 10, 5);
+  ck_assert_uint_eq(vector_span_size(part), 5);
+
+  int64_t expected = 10;
+  VECTOR_SPAN_FOREACH(it, part) {
+    ck_assert_int_eq(*(int64_t*)it, expected++);
+  }
+  ck_assert_int_eq(expected, 15);
+
+  vector_span empty = vector_subspan(v, 30, 0);
+  ck_assert_uint_eq(vector_span_size(empty), 0);
+  VECTOR_SPAN_FOREACH(it, empty) { ck_abort(); }
+
+  vector_deinit(v);
+}
+END_TEST
+
+START_TEST(test_element_size_kernels) {
+  /* fixed-width sizes and sizes that take the generic path */
+  size_t sizes[] = {1, 2, 3, 4, 8, 16, 24, 100};
+  unsigned char e[100];
+
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+    size_t size = sizes[s];
+    vector* v = vector_init(size);
+
+    /* every byte of an element repeats its key */
+    for (size_t i = 0; i < 200; ++i) {
+      memset(e, (int)((i * 37) % 200), size);
+      vector_push(v, e);
+    }
+    memset(e, 255, size);
+    vector_insert(v, e, vector_size(v));
+    vector_insert(v, e, 100);
+    vector_delete(v, 0);
+
+    vector_quicksort(v, cmp_first_byte);
+
+    ck_assert_uint_eq(vector_size(v), 201);
+    for (size_t i = 0; i < vector_size(v); ++i) {
+      unsigned char const* el = vector_at(v, i);
+      if (i > 0)
+        ck_assert_uint_le(el[-(ptrdiff_t)size], el[0]);
+      for (size_t b = 1; b < size; ++b) {
+        ck_assert_uint_eq(el[b], el[0]);
+      }
+    }
+    ck_assert_uint_eq(*(unsigned char*)vector_at(v, 199), 255);
+    ck_assert_uint_eq(*(unsigned char*)vector_at(v, 200), 255);
+
+    vector_deinit(v);
+  }
+}
+END_TEST
+
 /******************************* END TESTS ***********************************/
 
 Suite* vector_test_suite(void) {
@@ -584,6 +861,7 @@ Suite* vector_test_suite(void) {
   tcase_add_test(tc_core, test_unshift_elements);
   tcase_add_test(tc_core, test_delete_at_index);
   tcase_add_test(tc_core, test_remove_on_predicate);
+  tcase_add_test(tc_core, test_clear_keeps_capacity);
   tcase_add_test(tc_core, test_find_on_predicate);
   tcase_add_test(tc_core, test_auto_alloc);
   tcase_add_test(tc_core, test_replace_element);
@@ -603,6 +881,20 @@ Suite* vector_test_suite(void) {
   tcase_add_test(tc_core, test_binary_search_one_element);
   tcase_add_test(tc_core, test_binary_search_two_elements);
   tcase_add_test(tc_core, test_binary_search_same_elements);
+  tcase_add_test(tc_core, test_unchecked_access);
+  tcase_add_test(tc_core, test_empty_span);
+  tcase_add_test(tc_core, test_try_push_keeps_vector_on_failure);
+  tcase_add_test(tc_core, test_try_reserve);
+  tcase_add_test(tc_core, test_reserve);
+  tcase_add_test(tc_core, test_push_n);
+#ifdef GAL_ALLOC_STATS
+  tcase_add_test(tc_core, test_push_n_resizes_once);
+#endif
+  tcase_add_test(tc_core, test_extend);
+  tcase_add_test(tc_core, test_emplace_back);
+  tcase_add_test(tc_core, test_foreach);
+  tcase_add_test(tc_core, test_span);
+  tcase_add_test(tc_core, test_element_size_kernels);
 
   suite_add_tcase(s, tc_core);
   return s;
@@ -0,0 +1,218 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <check.h>
+#include <gal/vector_io.h>
+
+/********************************* TESTS *************************************/
+
+int cmp_int32_t(void const* a, void const* b) {
+  int32_t _a = *(int32_t*)a, _b = *(int32_t*)b;
+  if (_a < _b)
+    return -1;
+  if (_a > _b)
+    return 1;
+  return 0;
+}
+
+static int temp_file(void) {
+  char path[] = "/tmp/gal_vector_io_XXXXXX";
+  int fd = mkstemp(path);
+  unlink(path);
+  return fd;
+}
+
+static vector* make_vector(int32_t n) {
+  vector* v = vector_init(4);
+  for (int32_t i = 0; i < n; ++i) {
+    vector_push(v, &i);
+  }
+  return v;
+}
+
+START_TEST(test_write_and_read) {
+  int fd = temp_file();
+  vector* v = make_vector(1000);
+
+  ck_assert_int_eq(vector_write(v, fd), 0);
+  lseek(fd, 0, SEEK_SET);
+  vector* copy = vector_read(fd);
+
+  ck_assert_ptr_nonnull(copy);
+  ck_assert_uint_eq(vector_size(copy), 1000);
+  ck_assert(vector_cmp(v, copy, cmp_int32_t) == 0);
+
+  vector_deinit(copy);
+  vector_deinit(v);
+  close(fd);
+}
+END_TEST
+
+START_TEST(test_write_and_read_empty) {
+  int fd = temp_file();
+  vector* v = vector_init(8);
+
+  ck_assert_int_eq(vector_write(v, fd), 0);
+  lseek(fd, 0, SEEK_SET);
+  vector* copy = vector_read(fd);
+
+  ck_assert_ptr_nonnull(copy);
+  ck_assert(vector_is_empty(copy));
+
+  vector_deinit(copy);
+  vector_deinit(v);
+  close(fd);
+}
+END_TEST
+
+START_TEST(test_several_vectors_in_one_stream) {
+  int fd = temp_file();
+  vector* a = make_vector(3);
+  vector* b = make_vector(5);
+
+  vector_write(a, fd);
+  vector_write(b, fd);
+  lseek(fd, 0, SEEK_SET);
+
+  vector* a_copy = vector_read(fd);
+  vector* b_copy = vector_read(fd);
+
+  ck_assert(vector_cmp(a, a_copy, cmp_int32_t) == 0);
+  ck_assert(vector_cmp(b, b_copy, cmp_int32_t) == 0);
+
+  vector_deinit(a);
+  vector_deinit(b);
+  vector_deinit(a_copy);
+  vector_deinit(b_copy);
+  close(fd);
+}
+END_TEST
+
+START_TEST(test_read_mmap_view) {
+  int fd = temp_file();
+  vector* a = make_vector(10);
+  vector* b = make_vector(2000);
+
+  vector_write(a, fd);
+  vector_write(b, fd);
+  lseek(fd, 0, SEEK_SET);
+
+  vector* a_view = vector_read_mmap(fd);
+  vector* b_view = vector_read_mmap(fd);
+  close(fd);
+
+  ck_assert_ptr_nonnull(a_view);
+  ck_assert_ptr_nonnull(b_view);
+  ck_assert(vector_cmp(a, a_view, cmp_int32_t) == 0);
+  ck_assert(vector_cmp(b, b_view, cmp_int32_t) == 0);
+
+  int32_t key = 1234;
+  ck_assert_uint_eq(vector_bsearch(b_view, &key, cmp_int32_t), 1234);
+
+  vector_deinit(a_view);
+  vector_deinit(b_view);
+  vector_deinit(a);
+  vector_deinit(b);
+}
+END_TEST
+
+START_TEST(test_read_mmap_view_can_not_resize) {
+  int fd = temp_file();
+  vector* v = make_vector(100);
+  vector_write(v, fd);
+  lseek(fd, 0, SEEK_SET);
+  vector* view = vector_read_mmap(fd);
+  close(fd);
+
+  int32_t e = 100;
+  size_t capacity = vector_capacity(view);
+  errno = 0;
+  ck_assert_int_eq(vector_try_push(view, &e), -1);
+  ck_assert_int_eq(errno, EROFS);
+  ck_assert_int_eq(vector_try_reserve(view, capacity + 1), -1);
+  ck_assert_int_eq(errno, EROFS);
+
+  /* shrinking would write the header into the mapping */
+  free(vector_pop(view));
+  ck_assert_int_eq(vector_try_resize(view, vector_size(view)), -1);
+  ck_assert_int_eq(errno, EROFS);
+  ck_assert_uint_eq(vector_capacity(view), capacity);
+  ck_assert_uint_eq(vector_size(view), 99);
+  ck_assert_int_eq(*(int32_t*)vector_at(view, 98), 98);
+
+  vector_deinit(view);
+  vector_deinit(v);
+}
+END_TEST
+
+START_TEST(test_read_rejects_garbage) {
+  int fd = temp_file();
+  char garbage[64] = "definitely not a vector";
+  ck_assert_int_eq(write(fd, garbage, sizeof(garbage)), sizeof(garbage));
+
+  lseek(fd, 0, SEEK_SET);
+  errno = 0;
+  ck_assert_ptr_null(vector_read(fd));
+  ck_assert_int_eq(errno, EINVAL);
+
+  lseek(fd, 0, SEEK_SET);
+  errno = 0;
+  ck_assert_ptr_null(vector_read_mmap(fd));
+  ck_assert_int_eq(errno, EINVAL);
+
+  close(fd);
+}
+END_TEST
+
+START_TEST(test_read_truncated) {
+  int fd = temp_file();
+  vector* v = make_vector(100);
+
+  vector_write(v, fd);
+  ck_assert_int_eq(ftruncate(fd, 100), 0);
+
+  lseek(fd, 0, SEEK_SET);
+  errno = 0;
+  ck_assert_ptr_null(vector_read(fd));
+  ck_assert_int_eq(errno, EINVAL);
+
+  lseek(fd, 0, SEEK_SET);
+  errno = 0;
+  ck_assert_ptr_null(vector_read_mmap(fd));
+  ck_assert_int_eq(errno, EINVAL);
+
+  vector_deinit(v);
+  close(fd);
+}
+END_TEST
+
+/******************************* END TESTS ***********************************/
+
+Suite* vector_io_test_suite(void) {
+  Suite* s = suite_create("vector_io");
+  TCase* tc_core = tcase_create("core");
+
+  tcase_add_test(tc_core, test_write_and_read);
+  tcase_add_test(tc_core, test_write_and_read_empty);
+  tcase_add_test(tc_core, test_several_vectors_in_one_stream);
+  tcase_add_test(tc_core, test_read_mmap_view);
+  tcase_add_test(tc_core, test_read_mmap_view_can_not_resize);
+  tcase_add_test(tc_core, test_read_rejects_garbage);
+  tcase_add_test(tc_core, test_read_truncated);
+
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+int main(void) {
+  Suite* s = vector_io_test_suite();
+  SRunner* sr = srunner_create(s);
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
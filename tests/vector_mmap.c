@@ -0,0 +1,149 @@
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <check.h>
+#include <gal/vector_mmap.h>
+
+/********************************* TESTS *************************************/
+
+static char path[64];
+
+static void make_path(void) {
+  snprintf(path, sizeof(path), "/tmp/gal_vector_mmap_XXXXXX");
+  int fd = mkstemp(path);
+  close(fd);
+}
+
+START_TEST(test_open_empty_file) {
+  make_path();
+  vector* v = vector_open_mmap(path, 4);
+
+  ck_assert_ptr_nonnull(v);
+  ck_assert(vector_is_empty(v));
+  ck_assert_uint_eq(vector_capacity(v), 16);
+
+  vector_deinit(v);
+  unlink(path);
+}
+END_TEST
+
+START_TEST(test_elements_persist_across_reopen) {
+  make_path();
+  vector* v = vector_open_mmap(path, 4);
+
+  for (int32_t i = 0; i < 100; ++i) {
+    vector_push(v, &i);
+  }
+  ck_assert_uint_eq(vector_capacity(v), 128);
+  vector_deinit(v);
+
+  v = vector_open_mmap(path, 4);
+  ck_assert_ptr_nonnull(v);
+  ck_assert_uint_eq(vector_size(v), 100);
+  ck_assert_uint_eq(vector_capacity(v), 128);
+  for (int32_t i = 0; i < 100; ++i) {
+    ck_assert_int_eq(*(int32_t*)vector_at(v, i), i);
+  }
+
+  vector_deinit(v);
+  unlink(path);
+}
+END_TEST
+
+START_TEST(test_sync_stores_size) {
+  make_path();
+  vector* v = vector_open_mmap(path, 8);
+
+  for (int64_t i = 0; i < 10; ++i) {
+    vector_push(v, &i);
+  }
+  ck_assert_int_eq(vector_sync(v), 0);
+
+  /* a second mapping sees the synced state while the first is open */
+  vector* other = vector_open_mmap(path, 8);
+  ck_assert_uint_eq(vector_size(other), 10);
+  ck_assert_int_eq(*(int64_t*)vector_at(other, 9), 9);
+
+  vector_deinit(other);
+  vector_deinit(v);
+  unlink(path);
+}
+END_TEST
+
+START_TEST(test_shrink_after_pop) {
+  make_path();
+  vector* v = vector_open_mmap(path, 4);
+
+  for (int32_t i = 0; i < 17; ++i) {
+    vector_push(v, &i);
+  }
+  free(vector_pop(v));
+
+  ck_assert_uint_eq(vector_capacity(v), 16);
+  ck_assert_int_eq(*(int32_t*)vector_at(v, 15), 15);
+  vector_deinit(v);
+
+  v = vector_open_mmap(path, 4);
+  ck_assert_uint_eq(vector_size(v), 16);
+  vector_deinit(v);
+  unlink(path);
+}
+END_TEST
+
+START_TEST(test_element_size_mismatch) {
+  make_path();
+  vector* v = vector_open_mmap(path, 4);
+  vector_deinit(v);
+
+  errno = 0;
+  ck_assert_ptr_null(vector_open_mmap(path, 8));
+  ck_assert_int_eq(errno, EINVAL);
+
+  unlink(path);
+}
+END_TEST
+
+START_TEST(test_corrupted_header) {
+  make_path();
+  FILE* f = fopen(path, "w");
+  for (int i = 0; i < 128; ++i) {
+    fputc('x', f);
+  }
+  fclose(f);
+
+  errno = 0;
+  ck_assert_ptr_null(vector_open_mmap(path, 4));
+  ck_assert_int_eq(errno, EINVAL);
+
+  unlink(path);
+}
+END_TEST
+
+/******************************* END TESTS ***********************************/
+
+Suite* vector_mmap_test_suite(void) {
+  Suite* s = suite_create("vector_mmap");
+  TCase* tc_core = tcase_create("core");
+
+  tcase_add_test(tc_core, test_open_empty_file);
+  tcase_add_test(tc_core, test_elements_persist_across_reopen);
+  tcase_add_test(tc_core, test_sync_stores_size);
+  tcase_add_test(tc_core, test_shrink_after_pop);
+  tcase_add_test(tc_core, test_element_size_mismatch);
+  tcase_add_test(tc_core, test_corrupted_header);
+
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+int main(void) {
+  Suite* s = vector_mmap_test_suite();
+  SRunner* sr = srunner_create(s);
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,97 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <check.h>
+
+#include "../fuzz/vector_model.h"
+
+/********************************* TESTS *************************************/
+
+#define SEEDS 100
+#define INPUT_LENGTH 512
+
+/* Fills an input with xorshift64 output */
+static void random_input(uint8_t* data, size_t length, uint64_t seed) {
+  uint64_t x = seed * 0x9e3779b97f4a7c15ull + 1;
+  for (size_t i = 0; i < length; ++i) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    data[i] = (uint8_t)(x >> 32);
+  }
+}
+
+START_TEST(test_random_operations) {
+  uint8_t data[INPUT_LENGTH];
+  for (uint64_t seed = 0; seed < SEEDS; ++seed) {
+    random_input(data, sizeof(data), seed);
+    size_t op = vector_model_run(data, sizeof(data));
+    ck_assert_msg(op == 0, "seed %llu diverged at op %zu",
+                  (unsigned long long)seed, op);
+  }
+}
+END_TEST
+
+START_TEST(test_insert_at_end) {
+  /* 4-byte elements; push 7, insert 9 at index 1 == size */
+  uint8_t const data[] = {3,
+                          VECTOR_MODEL_PUSH,   7,
+                          VECTOR_MODEL_INSERT, 9, 1, 0};
+  ck_assert_uint_eq(vector_model_run(data, sizeof(data)), 0);
+}
+END_TEST
+
+START_TEST(test_remove_adjacent) {
+  /* neighbouring elements that both satisfy the predicate */
+  uint8_t const data[] = {3,
+                          VECTOR_MODEL_PUSH_N, 5, 4, 8, 1, 12, 16,
+                          VECTOR_MODEL_REMOVE};
+  ck_assert_uint_eq(vector_model_run(data, sizeof(data)), 0);
+}
+END_TEST
+
+START_TEST(test_bsearch_below_first) {
+  /* key less than every element makes the search step left of index 0 */
+  uint8_t const data[] = {3,
+                          VECTOR_MODEL_PUSH_N,  3, 10, 20, 30,
+                          VECTOR_MODEL_BSEARCH, 5,
+                          VECTOR_MODEL_BSEARCH, 10,
+                          VECTOR_MODEL_BSEARCH, 31};
+  ck_assert_uint_eq(vector_model_run(data, sizeof(data)), 0);
+}
+END_TEST
+
+START_TEST(test_remove_all_from_full) {
+  /* 16 elements fill the vector, and every one satisfies the predicate */
+  uint8_t const data[] = {3,
+                          VECTOR_MODEL_PUSH_N, 8, 0, 0, 0, 0, 0, 0, 0, 0,
+                          VECTOR_MODEL_PUSH_N, 8, 0, 0, 0, 0, 0, 0, 0, 0,
+                          VECTOR_MODEL_REMOVE};
+  ck_assert_uint_eq(vector_model_run(data, sizeof(data)), 0);
+}
+END_TEST
+
+/******************************* END TESTS ***********************************/
+
+Suite* vector_model_test_suite(void) {
+  Suite* s = suite_create("vector_model");
+  TCase* tc_core = tcase_create("core");
+
+  tcase_add_test(tc_core, test_random_operations);
+  tcase_add_test(tc_core, test_insert_at_end);
+  tcase_add_test(tc_core, test_remove_adjacent);
+  tcase_add_test(tc_core, test_bsearch_below_first);
+  tcase_add_test(tc_core, test_remove_all_from_full);
+
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+int main(void) {
+  Suite* s = vector_model_test_suite();
+  SRunner* sr = srunner_create(s);
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
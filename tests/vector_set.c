@@ -0,0 +1,236 @@
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <check.h>
+#include <gal/vector.h>
+#include <gal/vector_set.h>
+
+/********************************* TESTS *************************************/
+
+#define RANGE 64
+
+static int cmp_int32(void const* a, void const* b) {
+  int32_t x = *(int32_t const*)a, y = *(int32_t const*)b;
+  return (x > y) - (x < y);
+}
+
+static uint64_t next_random(uint64_t* x) {
+  *x ^= *x << 13;
+  *x ^= *x >> 7;
+  *x ^= *x << 17;
+  return *x;
+}
+
+/* Sorted vector of n values below RANGE, with duplicates, and the number of
+ * occurrences of every value */
+static vector* random_sorted(size_t n, uint64_t* rng, size_t* counts) {
+  for (size_t v = 0; v < RANGE; ++v) {
+    counts[v] = 0;
+  }
+  for (size_t i = 0; i < n; ++i) {
+    counts[next_random(rng) % RANGE] += 1;
+  }
+
+  vector* v = vector_init(sizeof(int32_t));
+  for (int32_t value = 0; value < RANGE; ++value) {
+    for (size_t c = 0; c < counts[value]; ++c) {
+      vector_push(v, &value);
+    }
+  }
+  return v;
+}
+
+/* Whether v is sorted and holds every value as often as `counts` says */
+static int has_counts(vector* v, size_t const* counts) {
+  size_t i = 0;
+  for (int32_t value = 0; value < RANGE; ++value) {
+    for (size_t c = 0; c < counts[value]; ++c, ++i) {
+      if (i >= vector_size(v) || *(int32_t*)vector_at(v, i) != value)
+        return 0;
+    }
+  }
+  return i == vector_size(v);
+}
+
+static size_t max_count(size_t a, size_t b) { return a > b ? a : b; }
+
+static size_t min_count(size_t a, size_t b) { return a < b ? a : b; }
+
+START_TEST(test_set_operations) {
+  /* balanced sizes and sizes far enough apart to gallop, both ways */
+  size_t sizes[][2] = {{0, 0},   {0, 50},   {50, 0},   {100, 120},
+                       {1, 500}, {500, 1},  {7, 1000}, {1000, 7},
+                       {40, 40}, {300, 290}};
+  uint64_t rng = 42;
+
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+    size_t ca[RANGE], cb[RANGE], expected[RANGE];
+    vector* a = random_sorted(sizes[s][0], &rng, ca);
+    vector* b = random_sorted(sizes[s][1], &rng, cb);
+    vector* out = vector_init(sizeof(int32_t));
+
+    ck_assert_int_eq(vector_set_merge(out, a, b, cmp_int32), 0);
+    for (size_t v = 0; v < RANGE; ++v) {
+      expected[v] = ca[v] + cb[v];
+    }
+    ck_assert(has_counts(out, expected));
+
+    vector_deinit(out);
+    out = vector_init(sizeof(int32_t));
+    ck_assert_int_eq(vector_set_union(out, a, b, cmp_int32), 0);
+    for (size_t v = 0; v < RANGE; ++v) {
+      expected[v] = max_count(ca[v], cb[v]);
+    }
+    ck_assert(has_counts(out, expected));
+
+    vector_deinit(out);
+    out = vector_init(sizeof(int32_t));
+    ck_assert_int_eq(vector_set_intersection(out, a, b, cmp_int32), 0);
+    for (size_t v = 0; v < RANGE; ++v) {
+      expected[v] = min_count(ca[v], cb[v]);
+    }
+    ck_assert(has_counts(out, expected));
+
+    vector_deinit(out);
+    out = vector_init(sizeof(int32_t));
+    ck_assert_int_eq(vector_set_difference(out, a, b, cmp_int32), 0);
+    for (size_t v = 0; v < RANGE; ++v) {
+      expected[v] = ca[v] > cb[v] ? ca[v] - cb[v] : 0;
+    }
+    ck_assert(has_counts(out, expected));
+
+    vector_deinit(out);
+    vector_deinit(b);
+    vector_deinit(a);
+  }
+}
+END_TEST
+
+START_TEST(test_appends_to_output) {
+  vector* a = vector_init(sizeof(int32_t));
+  vector* b = vector_init(sizeof(int32_t));
+  vector* out = vector_init(sizeof(int32_t));
+  for (int32_t i = 0; i < 10; ++i) {
+    vector_push(a, &i);
+    int32_t odd = 2 * i + 1;
+    vector_push(b, &odd);
+  }
+  int32_t marker = -1;
+  vector_push(out, &marker);
+
+  ck_assert_int_eq(vector_set_intersection(out, a, b, cmp_int32), 0);
+  ck_assert_uint_eq(vector_size(out), 6);
+  ck_assert_int_eq(*(int32_t*)vector_at(out, 0), -1);
+  ck_assert_int_eq(*(int32_t*)vector_at(out, 1), 1);
+  ck_assert_int_eq(*(int32_t*)vector_at(out, 5), 9);
+
+  vector_deinit(out);
+  vector_deinit(b);
+  vector_deinit(a);
+}
+END_TEST
+
+static void* limited_allocator(void* ptr, size_t old_size, size_t new_size) {
+  if (new_size > 64)
+    return NULL;
+  return gal_std_allocator(ptr, old_size, new_size);
+}
+
+START_TEST(test_out_unchanged_on_failure) {
+  vector* a = vector_init(sizeof(int32_t));
+  vector* b = vector_init(sizeof(int32_t));
+  for (int32_t i = 0; i < 20; ++i) {
+    vector_push(a, &i);
+    vector_push(b, &i);
+  }
+  vector* out = vector_init_with_allocator(sizeof(int32_t), limited_allocator);
+
+  errno = 0;
+  ck_assert_int_eq(vector_set_merge(out, a, b, cmp_int32), -1);
+  ck_assert_int_eq(errno, ENOMEM);
+  ck_assert_uint_eq(vector_size(out), 0);
+  ck_assert_int_eq(vector_set_difference(out, a, b, cmp_int32), -1);
+  ck_assert_uint_eq(vector_size(out), 0);
+
+  vector_deinit(out);
+  vector_deinit(b);
+  vector_deinit(a);
+}
+END_TEST
+
+START_TEST(test_intersection_u32) {
+  size_t sizes[][2] = {{0, 10},    {3, 5},     {4, 4},    {37, 41},
+                       {1000, 900}, {5, 2000}, {2000, 5}, {513, 1024}};
+  uint64_t rng = 7;
+
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+    vector* sets[2];
+    for (size_t k = 0; k < 2; ++k) {
+      sets[k] = vector_init(sizeof(uint32_t));
+      uint32_t value = 0;
+      for (size_t i = 0; i < sizes[s][k]; ++i) {
+        value += 1 + (uint32_t)(next_random(&rng) % 4);
+        vector_push(sets[k], &value);
+      }
+    }
+
+    vector* expected = vector_init(sizeof(uint32_t));
+    vector* out = vector_init(sizeof(uint32_t));
+    ck_assert_int_eq(
+        vector_set_intersection(expected, sets[0], sets[1], cmp_int32), 0);
+    ck_assert_int_eq(vector_set_intersection_u32(out, sets[0], sets[1]), 0);
+    ck_assert_int_eq(vector_cmp(out, expected, cmp_int32), 0);
+
+    vector_deinit(out);
+    vector_deinit(expected);
+    vector_deinit(sets[1]);
+    vector_deinit(sets[0]);
+  }
+}
+END_TEST
+
+START_TEST(test_intersection_u32_full_range) {
+  uint32_t xs[] = {0, 5, 0x7fffffff, 0x80000000, 0xfffffffe, 0xffffffff};
+  uint32_t ys[] = {0, 6, 0x80000000, 0x80000001, 0xfffffffe, 0xffffffff};
+  vector* a = vector_init(sizeof(uint32_t));
+  vector* b = vector_init(sizeof(uint32_t));
+  vector_push_n(a, xs, 6);
+  vector_push_n(b, ys, 6);
+
+  vector* out = vector_init(sizeof(uint32_t));
+  ck_assert_int_eq(vector_set_intersection_u32(out, a, b), 0);
+  ck_assert_uint_eq(vector_size(out), 4);
+  ck_assert_uint_eq(*(uint32_t*)vector_at(out, 1), 0x80000000);
+  ck_assert_uint_eq(*(uint32_t*)vector_at(out, 3), 0xffffffff);
+
+  vector_deinit(out);
+  vector_deinit(b);
+  vector_deinit(a);
+}
+END_TEST
+
+/******************************* END TESTS ***********************************/
+
+Suite* vector_set_test_suite(void) {
+  Suite* s = suite_create("vector_set");
+  TCase* tc_core = tcase_create("core");
+
+  tcase_add_test(tc_core, test_set_operations);
+  tcase_add_test(tc_core, test_appends_to_output);
+  tcase_add_test(tc_core, test_out_unchanged_on_failure);
+  tcase_add_test(tc_core, test_intersection_u32);
+  tcase_add_test(tc_core, test_intersection_u32_full_range);
+
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+int main(void) {
+  Suite* s = vector_set_test_suite();
+  SRunner* sr = srunner_create(s);
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}